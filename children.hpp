@@ -0,0 +1,659 @@
+/**
+ * @file children.hpp
+ * @brief Conjuntos de hijos adaptativos (estilo ART) para los nodos del Trie.
+ *
+ * Un nodo no guarda sus hijos directamente: guarda un `ChildRef` que apunta a
+ * un bloque en uno de tres pools según cuántos hijos tenga:
+ * - `Node4`:  hasta 4 claves ordenadas (búsqueda lineal).
+ * - `Node16`: hasta 16 claves ordenadas (búsqueda con SSE2 si está disponible).
+ * - `Node27`: arreglo directo indexado por el carácter (a-z + extras).
+ *
+ * Con un alfabeto de 27 símbolos la variante Node48 de ART no aporta nada
+ * frente al arreglo completo, por lo que se omite.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef CHILDREN_HPP
+#define CHILDREN_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "pool.hpp"
+#include "epoch.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Tipo de bloque de hijos.
+ */
+enum ChildKind : uint8_t { KIND_NONE = 0, KIND_4 = 1, KIND_16 = 2, KIND_27 = 3 };
+
+/**
+ * @brief Layout de los hijos de un Trie.
+ *
+ * - `FIXED_LAYOUT` (0): todo nodo reserva el arreglo de 27 hijos.
+ * - `ADAPTIVE_LAYOUT` (1): los nodos crecen de Node4 a Node16 y a Node27.
+ */
+enum Layout { FIXED_LAYOUT = 0, ADAPTIVE_LAYOUT = 1 };
+
+/**
+ * @brief Referencia desde un nodo a su bloque de hijos.
+ *
+ * Ocupa 8 bytes alineados para que el modo concurrente la publique y la lea
+ * con una sola operación atómica (ver `ChildStore::load`).
+ */
+struct alignas(8) ChildRef {
+    uint32_t block;   /**< Índice del bloque en el pool de su tipo */
+    uint8_t kind;     /**< `ChildKind` del bloque */
+    uint8_t count;    /**< Cantidad de hijos */
+    uint16_t spare;   /**< Relleno explícito, siempre 0 (los snapshots copian la estructura tal cual) */
+};
+
+/** @brief Bloque de hasta 4 hijos con claves ordenadas. */
+struct Node4 {
+    uint8_t keys[4];
+    uint32_t child[4];
+};
+
+/** @brief Bloque de hasta 16 hijos con claves ordenadas. */
+struct Node16 {
+    uint8_t keys[16];
+    uint32_t child[16];
+};
+
+/** @brief Bloque completo indexado directamente por la clave. */
+struct Node27 {
+    uint32_t child[27];
+};
+
+/**
+ * @brief Posición de los bloques de otro `ChildStore` copiados en éste.
+ */
+struct ChildSpan {
+    uint32_t n4;    /**< Índice donde queda el bloque Node4 número 1 */
+    uint32_t n16;   /**< Índice donde queda el bloque Node16 número 1 */
+    uint32_t n27;   /**< Índice donde queda el bloque Node27 número 1 */
+};
+
+/**
+ * @brief Almacén de bloques de hijos de todos los nodos de un Trie.
+ *
+ * Las claves son índices 0..26 (ver `charToIndex`) y los hijos son índices de
+ * nodo (0 = sin hijo). Los bloques liberados al crecer o al borrar nodos se
+ * reutilizan.
+ *
+ * En modo concurrente (`set_concurrent`) los bloques Node4/Node16 no se
+ * modifican una vez publicados: `add` arma una copia con el hijo nuevo y la
+ * publica reemplazando el `ChildRef` de forma atómica, y el bloque viejo se
+ * retira hasta que ningún lector pueda estar usándolo. En Node27 el hijo se
+ * escribe directamente en su casilla, que nunca cambia de dueño.
+ */
+class ChildStore {
+public:
+    /**
+     * @brief Lee atómicamente la referencia de un nodo que otro hilo puede
+     * estar reemplazando.
+     * @param r Referencia guardada en el nodo.
+     */
+    static ChildRef load(const ChildRef& r) {
+        ChildRef out;
+        __atomic_load(&r, &out, __ATOMIC_ACQUIRE);
+        return out;
+    }
+
+    /**
+     * @brief Activa o desactiva el modo concurrente (copiar al escribir).
+     *
+     * Al desactivarlo no debe quedar ningún lector: los bloques retirados se
+     * devuelven de inmediato a las listas libres.
+     *
+     * @param m Épocas de los lectores (nullptr = modo normal).
+     */
+    void set_concurrent(EpochManager* m) {
+        epochs = m;
+        if (!m) reclaim(UINT64_MAX);
+    }
+
+    /** @brief Épocas del modo concurrente (nullptr = modo normal). */
+    EpochManager* concurrent() const { return epochs; }
+
+    /**
+     * @brief Busca el hijo con clave `key`.
+     * @param r Referencia a los hijos del nodo.
+     * @param key Clave 0..26.
+     * @return Índice del hijo o 0 si no existe.
+     */
+    uint32_t find(const ChildRef& r, uint8_t key) const {
+        switch (r.kind) {
+            case KIND_4: {
+                const Node4& n = n4[r.block];
+                for (int i = 0; i < r.count; ++i) {
+                    if (n.keys[i] == key) return n.child[i];
+                }
+                return 0;
+            }
+            case KIND_16: {
+                const Node16& n = n16[r.block];
+#ifdef __SSE2__
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)key),
+                                             _mm_loadu_si128((const __m128i*)n.keys));
+                unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & ((1u << r.count) - 1);
+                return mask ? n.child[__builtin_ctz(mask)] : 0;
+#else
+                for (int i = 0; i < r.count; ++i) {
+                    if (n.keys[i] == key) return n.child[i];
+                }
+                return 0;
+#endif
+            }
+            case KIND_27:
+                return __atomic_load_n(&n27[r.block].child[key], __ATOMIC_ACQUIRE);
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * @brief Pide a la caché la parte del bloque que leerá `find(r, key)`,
+     * sin esperarla.
+     * @param r Referencia a los hijos del nodo.
+     * @param key Clave 0..26.
+     */
+    void prefetch(const ChildRef& r, uint8_t key) const {
+        switch (r.kind) {
+            case KIND_4:
+                __builtin_prefetch(&n4[r.block]);
+                break;
+            case KIND_16:
+                __builtin_prefetch(n16[r.block].keys);
+                __builtin_prefetch(&n16[r.block].child[15]);
+                break;
+            case KIND_27:
+                __builtin_prefetch(&n27[r.block].child[key]);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Agrega el hijo `child` con clave `key` (que no debe existir).
+     *
+     * Si el bloque está lleno se copia a uno del tipo siguiente.
+     *
+     * @param r Referencia a los hijos del nodo (se actualiza).
+     * @param key Clave 0..26.
+     * @param child Índice del nodo hijo.
+     */
+    void add(ChildRef& r, uint8_t key, uint32_t child) {
+        if (epochs) {
+            add_shared(r, key, child);
+            return;
+        }
+        if (r.kind == KIND_NONE) {
+            r.kind = KIND_4;
+            if (free4) {
+                r.block = free4;
+                free4 = n4[free4].child[0];
+            } else {
+                r.block = n4.alloc();
+            }
+        } else if (r.kind == KIND_4 && r.count == 4) {
+            grow_to_16(r);
+        } else if (r.kind == KIND_16 && r.count == 16) {
+            make_full(r);
+        }
+
+        switch (r.kind) {
+            case KIND_4:
+                insert_sorted(n4[r.block].keys, n4[r.block].child, r.count, key, child);
+                break;
+            case KIND_16:
+                insert_sorted(n16[r.block].keys, n16[r.block].child, r.count, key, child);
+                break;
+            default:
+                n27[r.block].child[key] = child;
+                break;
+        }
+        r.count++;
+    }
+
+    /**
+     * @brief Quita el hijo con clave `key` (que debe existir).
+     *
+     * Node4 y Node16 se compactan y, al quedar vacíos, vuelven a su lista
+     * libre. Node27 conserva su bloque aunque quede vacío (el layout fijo
+     * cuenta con él) hasta que el nodo se libera con `clear`. No admite el
+     * modo concurrente.
+     *
+     * @param r Referencia a los hijos del nodo (se actualiza).
+     * @param key Clave 0..26.
+     */
+    void remove(ChildRef& r, uint8_t key) {
+        switch (r.kind) {
+            case KIND_4:
+                erase_sorted(n4[r.block].keys, n4[r.block].child, r.count, key);
+                break;
+            case KIND_16:
+                erase_sorted(n16[r.block].keys, n16[r.block].child, r.count, key);
+                break;
+            case KIND_27:
+                n27[r.block].child[key] = 0;
+                break;
+            default:
+                return;
+        }
+        r.count--;
+        if (r.count == 0 && r.kind != KIND_27) clear(r);
+    }
+
+    /**
+     * @brief Reemplaza el hijo asociado a `key` (que debe existir).
+     * @param r Referencia a los hijos del nodo.
+     * @param key Clave 0..26.
+     * @param child Nuevo índice de nodo hijo.
+     */
+    void replace(const ChildRef& r, uint8_t key, uint32_t child) {
+        switch (r.kind) {
+            case KIND_4:
+                for (int i = 0; i < r.count; ++i) {
+                    if (n4[r.block].keys[i] == key) n4[r.block].child[i] = child;
+                }
+                break;
+            case KIND_16:
+                for (int i = 0; i < r.count; ++i) {
+                    if (n16[r.block].keys[i] == key) n16[r.block].child[i] = child;
+                }
+                break;
+            case KIND_27:
+                n27[r.block].child[key] = child;
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Convierte los hijos de `r` al bloque completo de 27 entradas.
+     *
+     * Se usa al crecer desde Node16 y para el layout fijo, que reserva el
+     * bloque completo al crear cada nodo.
+     *
+     * @param r Referencia a los hijos del nodo (se actualiza).
+     */
+    void make_full(ChildRef& r) {
+        if (r.kind == KIND_27) return;
+        uint32_t b = take27();
+        Node27& full = n27[b];
+        memset(full.child, 0, sizeof(full.child));
+        for_each(r, [&](uint8_t key, uint32_t child) { full.child[key] = child; });
+        release(r);
+        r.kind = KIND_27;
+        r.block = b;
+    }
+
+    /**
+     * @brief Recorre los hijos en orden de clave.
+     * @param r Referencia a los hijos del nodo.
+     * @param f Función `f(key, child)`.
+     */
+    template <typename F>
+    void for_each(const ChildRef& r, F f) const {
+        switch (r.kind) {
+            case KIND_4: {
+                const Node4& n = n4[r.block];
+                for (int i = 0; i < r.count; ++i) f(n.keys[i], n.child[i]);
+                break;
+            }
+            case KIND_16: {
+                const Node16& n = n16[r.block];
+                for (int i = 0; i < r.count; ++i) f(n.keys[i], n.child[i]);
+                break;
+            }
+            case KIND_27: {
+                const Node27& n = n27[r.block];
+                for (int k = 0; k < 27; ++k) {
+                    if (n.child[k]) f((uint8_t)k, n.child[k]);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Libera el bloque de hijos de un nodo (que queda sin hijos).
+     * @param r Referencia a los hijos del nodo (se actualiza).
+     */
+    void clear(ChildRef& r) {
+        release(r);
+        r = ChildRef{0, KIND_NONE, 0};
+    }
+
+    /**
+     * @brief Reserva espacio para todos los bloques de `o` (ver `copy_from`).
+     * @param o Almacén a copiar.
+     * @return Dónde quedará cada tipo de bloque.
+     */
+    ChildSpan reserve(const ChildStore& o) {
+        return ChildSpan{n4.alloc_span(o.n4.size() - 1),
+                         n16.alloc_span(o.n16.size() - 1),
+                         n27.alloc_span(o.n27.size() - 1)};
+    }
+
+    /**
+     * @brief Traduce una referencia de `o` a su copia en este almacén.
+     * @param r Referencia válida en `o`.
+     * @param s Resultado de `reserve(o)`.
+     */
+    static ChildRef translate(ChildRef r, const ChildSpan& s) {
+        switch (r.kind) {
+            case KIND_4:  r.block += s.n4 - 1; break;
+            case KIND_16: r.block += s.n16 - 1; break;
+            case KIND_27: r.block += s.n27 - 1; break;
+            default: break;
+        }
+        return r;
+    }
+
+    /**
+     * @brief Copia los bloques de `o` en el espacio reservado.
+     *
+     * Los hijos se traducen con `node_map`. Sólo escribe dentro de `s`, así
+     * que puede llamarse en paralelo para distintos almacenes; los bloques
+     * libres de `o` se enlazan después con `splice_free`.
+     *
+     * @param o Almacén a copiar.
+     * @param s Resultado de `reserve(o)`.
+     * @param node_map Traducción de índices de nodo.
+     */
+    template <typename F>
+    void copy_from(const ChildStore& o, const ChildSpan& s, F node_map) {
+        for (uint32_t b = 1; b < o.n4.size(); ++b) {
+            Node4& d = n4[s.n4 + b - 1];
+            d = o.n4[b];
+            for (uint32_t& c : d.child) c = node_map(c);
+        }
+        for (uint32_t b = 1; b < o.n16.size(); ++b) {
+            Node16& d = n16[s.n16 + b - 1];
+            d = o.n16[b];
+            for (uint32_t& c : d.child) c = node_map(c);
+        }
+        for (uint32_t b = 1; b < o.n27.size(); ++b) {
+            Node27& d = n27[s.n27 + b - 1];
+            d = o.n27[b];
+            for (uint32_t& c : d.child) c = node_map(c);
+        }
+    }
+
+    /**
+     * @brief Copia un bloque de `o` en un bloque nuevo del mismo tipo.
+     *
+     * A diferencia de `copy_from`, copia un solo bloque y lo ubica al final
+     * de su pool, así que copiar los bloques en cierto orden los deja
+     * contiguos en ese orden.
+     *
+     * @param o Almacén de origen.
+     * @param r Referencia válida en `o`.
+     * @param node_map Traducción de índices de nodo.
+     * @return Referencia al bloque nuevo.
+     */
+    template <typename F>
+    ChildRef copy_block(const ChildStore& o, ChildRef r, F node_map) {
+        switch (r.kind) {
+            case KIND_4: {
+                uint32_t b = n4.alloc();
+                Node4& d = n4[b];
+                d = Node4{};
+                for (int i = 0; i < r.count; ++i) {
+                    d.keys[i] = o.n4[r.block].keys[i];
+                    d.child[i] = node_map(o.n4[r.block].child[i]);
+                }
+                r.block = b;
+                break;
+            }
+            case KIND_16: {
+                uint32_t b = n16.alloc();
+                Node16& d = n16[b];
+                d = Node16{};
+                for (int i = 0; i < r.count; ++i) {
+                    d.keys[i] = o.n16[r.block].keys[i];
+                    d.child[i] = node_map(o.n16[r.block].child[i]);
+                }
+                r.block = b;
+                break;
+            }
+            case KIND_27: {
+                uint32_t b = n27.alloc();
+                for (int k = 0; k < 27; ++k) {
+                    uint32_t c = o.n27[r.block].child[k];
+                    n27[b].child[k] = c ? node_map(c) : 0;
+                }
+                r.block = b;
+                break;
+            }
+            default:
+                break;
+        }
+        return r;
+    }
+
+    /**
+     * @brief Agrega a las listas libres las copias de los bloques libres de `o`.
+     * @param o Almacén copiado con `copy_from`.
+     * @param s Resultado de `reserve(o)`.
+     */
+    void splice_free(const ChildStore& o, const ChildSpan& s) {
+        for (uint32_t b = o.free4; b; b = o.n4[b].child[0]) {
+            n4[s.n4 + b - 1].child[0] = free4;
+            free4 = s.n4 + b - 1;
+        }
+        for (uint32_t b = o.free16; b; b = o.n16[b].child[0]) {
+            n16[s.n16 + b - 1].child[0] = free16;
+            free16 = s.n16 + b - 1;
+        }
+        for (uint32_t b = o.free27; b; b = o.n27[b].child[0]) {
+            n27[s.n27 + b - 1].child[0] = free27;
+            free27 = s.n27 + b - 1;
+        }
+    }
+
+    /**
+     * @brief Bytes ocupados por los bloques de hijos.
+     */
+    size_t bytes() const { return n4.bytes() + n16.bytes() + n27.bytes(); }
+
+    /**
+     * @brief (Escritor) Reutiliza los bloques retirados que ya no pueden
+     * estar en uso; intenta avanzar la época cuando hay suficientes pendientes.
+     */
+    void collect() {
+        if (!epochs || retired.size() < 64) return;
+        reclaim(epochs->try_advance());
+    }
+
+    /** @brief Cantidad de bloques retirados que aún esperan a los lectores. */
+    size_t retired_blocks() const { return retired.size(); }
+
+    /**
+     * @brief Aplica `f` a cada pool de bloques, siempre en el mismo orden
+     * (para guardar y cargar snapshots).
+     */
+    template <typename F>
+    void for_each_pool(F f) { f(n4); f(n16); f(n27); }
+
+    template <typename F>
+    void for_each_pool(F f) const { f(n4); f(n16); f(n27); }
+
+    /** @brief Cabezas de las listas libres de Node4, Node16 y Node27. */
+    uint32_t free_list4() const { return free4; }
+    uint32_t free_list16() const { return free16; }
+    uint32_t free_list27() const { return free27; }
+
+    /**
+     * @brief Restaura las listas libres (después de cargar los pools).
+     */
+    void set_free_lists(uint32_t f4, uint32_t f16, uint32_t f27) {
+        free4 = f4;
+        free16 = f16;
+        free27 = f27;
+        retired.clear();
+    }
+
+private:
+    /** @brief Bloque reemplazado en modo concurrente. */
+    struct Retired {
+        uint64_t epoch;   /**< Época global al retirarlo */
+        uint32_t block;   /**< Índice del bloque */
+        uint8_t kind;     /**< `ChildKind` del bloque */
+    };
+
+    Pool<Node4> n4;                /**< Bloques de 4 hijos */
+    Pool<Node16> n16;              /**< Bloques de 16 hijos */
+    Pool<Node27> n27;              /**< Bloques de 27 hijos */
+    uint32_t free4 = 0;            /**< Lista de bloques Node4 libres */
+    uint32_t free16 = 0;           /**< Lista de bloques Node16 libres */
+    uint32_t free27 = 0;           /**< Lista de bloques Node27 libres (de nodos borrados) */
+    EpochManager* epochs = nullptr;  /**< Épocas de los lectores (modo concurrente) */
+    vector<Retired> retired;       /**< Bloques retirados, en orden de época */
+
+    uint32_t take4() {
+        if (!free4) return n4.alloc();
+        uint32_t b = free4;
+        free4 = n4[b].child[0];
+        return b;
+    }
+
+    uint32_t take16() {
+        if (!free16) return n16.alloc();
+        uint32_t b = free16;
+        free16 = n16[b].child[0];
+        return b;
+    }
+
+    uint32_t take27() {
+        if (!free27) return n27.alloc();
+        uint32_t b = free27;
+        free27 = n27[b].child[0];
+        return b;
+    }
+
+    /**
+     * @brief `add` en modo concurrente: copia, agrega y publica.
+     */
+    void add_shared(ChildRef& r, uint8_t key, uint32_t child) {
+        ChildRef nuevo = r;
+        if (r.kind == KIND_27) {
+            __atomic_store_n(&n27[r.block].child[key], child, __ATOMIC_RELEASE);
+            nuevo.count++;
+            __atomic_store(&r, &nuevo, __ATOMIC_RELEASE);
+            return;
+        }
+
+        if (r.kind == KIND_NONE || (r.kind == KIND_4 && r.count < 4)) {
+            nuevo = ChildRef{take4(), KIND_4, r.count};
+            Node4& d = n4[nuevo.block];
+            if (r.kind == KIND_4) d = n4[r.block];
+            insert_sorted(d.keys, d.child, nuevo.count, key, child);
+        } else if (r.kind == KIND_4 || r.count < 16) {
+            nuevo = ChildRef{take16(), KIND_16, r.count};
+            Node16& d = n16[nuevo.block];
+            if (r.kind == KIND_16) {
+                d = n16[r.block];
+            } else {
+                memset(d.keys, 0xFF, sizeof(d.keys));
+                memcpy(d.keys, n4[r.block].keys, r.count);
+                memcpy(d.child, n4[r.block].child, r.count * sizeof(uint32_t));
+            }
+            insert_sorted(d.keys, d.child, nuevo.count, key, child);
+        } else {
+            nuevo = ChildRef{take27(), KIND_27, r.count};
+            Node27& d = n27[nuevo.block];
+            memset(d.child, 0, sizeof(d.child));
+            for_each(r, [&](uint8_t k, uint32_t c) { d.child[k] = c; });
+            d.child[key] = child;
+        }
+        nuevo.count++;
+
+        ChildRef viejo = r;
+        __atomic_store(&r, &nuevo, __ATOMIC_RELEASE);
+        if (viejo.kind != KIND_NONE) retired.push_back(Retired{epochs->current(), viejo.block, viejo.kind});
+    }
+
+    /**
+     * @brief Devuelve a las listas libres los bloques retirados antes de
+     * `global - 1`.
+     */
+    void reclaim(uint64_t global) {
+        size_t i = 0;
+        while (i < retired.size() && (global == UINT64_MAX || retired[i].epoch + 2 <= global)) {
+            release(ChildRef{retired[i].block, retired[i].kind, 0});
+            i++;
+        }
+        retired.erase(retired.begin(), retired.begin() + i);
+    }
+
+    template <size_t N>
+    static void insert_sorted(uint8_t (&keys)[N], uint32_t (&child)[N],
+                              uint8_t count, uint8_t key, uint32_t c) {
+        int i = count;
+        while (i > 0 && keys[i - 1] > key) {
+            keys[i] = keys[i - 1];
+            child[i] = child[i - 1];
+            --i;
+        }
+        keys[i] = key;
+        child[i] = c;
+    }
+
+    template <size_t N>
+    static void erase_sorted(uint8_t (&keys)[N], uint32_t (&child)[N], uint8_t count, uint8_t key) {
+        int i = 0;
+        while (keys[i] != key) ++i;
+        for (; i + 1 < count; ++i) {
+            keys[i] = keys[i + 1];
+            child[i] = child[i + 1];
+        }
+        keys[count - 1] = 0xFF;  // las claves sin uso no deben coincidir con ninguna
+    }
+
+    void grow_to_16(ChildRef& r) {
+        uint32_t b;
+        if (free16) {
+            b = free16;
+            free16 = n16[b].child[0];
+        } else {
+            b = n16.alloc();
+        }
+        Node16& big = n16[b];
+        const Node4& small = n4[r.block];
+        memset(big.keys, 0xFF, sizeof(big.keys));
+        memcpy(big.keys, small.keys, r.count);
+        memcpy(big.child, small.child, r.count * sizeof(uint32_t));
+        release(r);
+        r.kind = KIND_16;
+        r.block = b;
+    }
+
+    void release(const ChildRef& r) {
+        if (r.kind == KIND_4) {
+            n4[r.block].child[0] = free4;
+            free4 = r.block;
+        } else if (r.kind == KIND_16) {
+            n16[r.block].child[0] = free16;
+            free16 = r.block;
+        } else if (r.kind == KIND_27) {
+            n27[r.block].child[0] = free27;
+            free27 = r.block;
+        }
+    }
+};
+
+#endif
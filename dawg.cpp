@@ -0,0 +1,222 @@
+/**
+ * @file dawg.cpp
+ * @brief Construcción del autómata mínimo, conteo de caminos y consultas por rango.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#include "dawg.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+static constexpr uint32_t FINAL = 1u << 31;
+
+/**
+ * @brief Constructor del diccionario vacío.
+ *
+ * @param variant_mode Modo de prioridad para el autocompletado (FREQUENCY, RECENT o DECAYED).
+ */
+Dawg::Dawg(int variant_mode) {
+    variant = variant_mode;
+    build({});
+}
+
+/**
+ * @brief Toma las palabras alcanzables desde la raíz de `t`, con su
+ * prioridad, y construye el autómata.
+ *
+ * @param t Trie de origen.
+ */
+Dawg::Dawg(const Trie& t) {
+    variant = t.variant;
+    vector<string_view> palabras;
+    vector<uint32_t> prioridades;
+
+    vector<uint32_t> pila{t.root};
+    while (!pila.empty()) {
+        const TrieNode& n = t.nodes[pila.back()];
+        pila.pop_back();
+        if (n.is_terminal) {
+            palabras.push_back(t.words.get(n.word));
+            prioridades.push_back(n.priority);
+        }
+        t.children.for_each(n.children, [&](uint8_t, uint32_t child) { pila.push_back(child); });
+    }
+    build(palabras, prioridades);
+    global_counter = max(global_counter, t.global_counter);
+}
+
+void Dawg::build(const vector<string_view>& palabras, const vector<uint32_t>& prioridades) {
+    // palabras como secuencias de símbolos, ordenadas (estable: ante caminos
+    // iguales queda primero la que venía primero)
+    vector<string> simbolos(palabras.size());
+    for (size_t i = 0; i < palabras.size(); ++i) {
+        simbolos[i].resize(palabras[i].size());
+        for (size_t j = 0; j < palabras[i].size(); ++j) simbolos[i][j] = (char)charToIndex(palabras[i][j]);
+    }
+    vector<uint32_t> orden(palabras.size());
+    for (uint32_t i = 0; i < orden.size(); ++i) orden[i] = i;
+    stable_sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) { return simbolos[a] < simbolos[b]; });
+
+    states.assign(1, DawgState{0, 0});
+    edges.clear();
+    chars.clear();
+    offsets.assign(1, 0);
+    priorities.assign(1, 0);
+    global_counter = 1;
+
+    struct Pendiente {
+        bool final = false;
+        vector<pair<uint8_t, uint32_t>> edges;   /**< (símbolo, estado ya registrado) */
+    };
+    unordered_map<string, uint32_t> registro;   // firma del estado -> estado
+    string firma;
+
+    // reemplaza un estado pendiente por uno equivalente ya registrado, o lo registra
+    auto congelar = [&](const Pendiente& s) -> uint32_t {
+        firma.assign(1, s.final ? '\1' : '\0');
+        for (const auto& e : s.edges) {
+            firma.push_back((char)e.first);
+            firma.append(reinterpret_cast<const char*>(&e.second), sizeof(e.second));
+        }
+        auto it = registro.find(firma);
+        if (it != registro.end()) return it->second;
+
+        uint32_t id = (uint32_t)states.size();
+        uint32_t cuenta = s.final ? 1 : 0;
+        states.push_back(DawgState{(uint32_t)edges.size(), 0});
+        for (const auto& e : s.edges) {
+            edges.push_back(DawgEdge{(e.second << 5) | e.first, cuenta});
+            cuenta += states[e.second].words & ~FINAL;
+        }
+        states[id].words = cuenta | (s.final ? FINAL : 0);
+        registro.emplace(firma, id);
+        return id;
+    };
+
+    vector<Pendiente> camino(1);   // camino de la palabra anterior, aún sin registrar
+    const string* anterior = nullptr;
+    for (uint32_t i : orden) {
+        const string& w = simbolos[i];
+        if (anterior && w == *anterior) continue;   // mismo camino: se conserva la primera
+
+        size_t comun = 0;
+        if (anterior) {
+            while (comun < w.size() && comun < anterior->size() && w[comun] == (*anterior)[comun]) comun++;
+        }
+        for (size_t d = camino.size() - 1; d > comun; --d) {
+            camino[d - 1].edges.back().second = congelar(camino[d]);
+        }
+        camino.resize(comun + 1);
+        for (size_t d = comun; d < w.size(); ++d) {
+            camino.back().edges.push_back({(uint8_t)w[d], 0});
+            camino.emplace_back();
+        }
+        camino.back().final = true;
+
+        chars.insert(chars.end(), palabras[i].begin(), palabras[i].end());
+        offsets.push_back((uint32_t)chars.size());
+        uint32_t p = prioridades.empty() ? 0 : prioridades[i];
+        priorities.push_back(p);
+        if (variant == RECENT) global_counter = max(global_counter, p + 1);
+        anterior = &w;
+    }
+    for (size_t d = camino.size() - 1; d > 0; --d) camino[d - 1].edges.back().second = congelar(camino[d]);
+    root = congelar(camino[0]);
+    states.push_back(DawgState{(uint32_t)edges.size(), 0});   // centinela: fin de las aristas del último
+
+    build_best();
+}
+
+/**
+ * @brief Avanza un carácter sumando las palabras que quedan a la izquierda.
+ *
+ * El índice de la posición crece en `before` de la arista tomada: la
+ * palabra del propio estado (si es final) y las de las aristas menores.
+ */
+DawgPos Dawg::descend(DawgPos p, const char c) const {
+    if (!p.state) return DawgPos{0, 0};
+    uint32_t simbolo = (uint32_t)charToIndex(c);
+    for (uint32_t e = states[p.state].first; e < states[p.state + 1].first; ++e) {
+        uint32_t s = edges[e].target & 31;
+        if (s == simbolo) return DawgPos{edges[e].target >> 5, p.index + edges[e].before};
+        if (s > simbolo) break;
+    }
+    return DawgPos{0, 0};
+}
+
+uint32_t Dawg::lookup(string_view w) const {
+    DawgPos p = get_root();
+    for (char c : w) {
+        p = descend(p, c);
+        if (!p) return 0;
+    }
+    return word_id(p);
+}
+
+/**
+ * @brief Las extensiones estrictas del prefijo son los ids
+ * `[index + 1 + final, index + palabras(estado)]`: la palabra igual al
+ * prefijo, si existe, es la menor del rango y se salta.
+ */
+uint32_t Dawg::autocomplete(DawgPos p) const {
+    if (!p.state) return 0;
+    const DawgState& s = states[p.state];
+    uint32_t l = p.index + 1 + (s.words >> 31) + leaves;
+    uint32_t r = p.index + (s.words & ~FINAL) + 1 + leaves;
+
+    uint32_t res = 0;
+    while (l < r) {
+        if (l & 1) res = better(res, best[l++]);
+        if (r & 1) res = better(res, best[--r]);
+        l >>= 1;
+        r >>= 1;
+    }
+    return res;
+}
+
+/**
+ * @brief Actualiza la prioridad y recalcula los rangos que contienen a `id`.
+ * Costo O(log palabras).
+ */
+void Dawg::update_priority(uint32_t id) {
+    if (!id) return;
+    withPolicy(variant, [&](auto p) {
+        using Policy = decltype(p);
+        priorities[id] = Policy::bump(priorities[id], global_counter);
+        if (Policy::needs_rescale(global_counter)) {
+            // corrimiento uniforme: el árbol de mejores sigue siendo válido
+            for (uint32_t& q : priorities) q = Policy::rescale(q);
+            global_counter = Policy::rescale_counter(global_counter);
+        }
+    });
+
+    uint32_t i = leaves + id;
+    best[i] = priorities[id] ? id : 0;
+    for (i >>= 1; i > 0; i >>= 1) best[i] = better(best[2 * i], best[2 * i + 1]);
+}
+
+/**
+ * @brief El de mayor prioridad entre dos ids (0 = ninguno); en empates, el menor.
+ */
+uint32_t Dawg::better(uint32_t a, uint32_t b) const {
+    if (!a) return b;
+    if (!b) return a;
+    if (priorities[a] != priorities[b]) return priorities[a] > priorities[b] ? a : b;
+    return min(a, b);
+}
+
+/**
+ * @brief Arma el árbol de segmentos sobre los ids (sólo los de prioridad > 0).
+ *
+ * Es la variante iterativa de 2n posiciones, sin rellenar a una potencia de
+ * 2: sirve porque `better` es asociativa y conmutativa.
+ */
+void Dawg::build_best() {
+    leaves = (uint32_t)priorities.size();
+    best.assign(2 * (size_t)leaves, 0);
+    for (uint32_t id = 1; id < priorities.size(); ++id) best[leaves + id] = priorities[id] ? id : 0;
+    for (uint32_t i = leaves - 1; i > 0; --i) best[i] = better(best[2 * i], best[2 * i + 1]);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file dawg.hpp
+ * @brief Diccionario como autómata acíclico mínimo (DAWG) con ids densos.
+ *
+ * Un Trie comparte prefijos pero repite los sufijos: "-ation", "-ness",
+ * "-ing" aparecen una vez por cada palabra que los usa. El autómata mínimo
+ * fusiona además todos los estados con el mismo lenguaje derecho, así que
+ * cada sufijo común se guarda una sola vez.
+ *
+ * Como un estado lo comparten muchas palabras, no puede guardar prioridades
+ * ni mejores terminales. En cambio cada estado guarda cuántas palabras
+ * acepta desde él, y con eso el camino de una palabra da su posición en
+ * orden lexicográfico (hash perfecto mínimo por conteo de caminos). Las
+ * palabras que comparten un prefijo ocupan un rango contiguo de ids, de
+ * modo que la mejor completación de un prefijo es el máximo de un rango del
+ * arreglo de prioridades, que se responde con un árbol de segmentos.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef DAWG_HPP
+#define DAWG_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "trie.hpp"
+
+using namespace std;
+
+/**
+ * @brief Estado del autómata.
+ *
+ * Sus aristas son `edges[first, siguiente.first)`, ordenadas por símbolo.
+ */
+struct DawgState {
+    uint32_t first;   /**< Primera arista del estado */
+    uint32_t words;   /**< Palabras aceptadas desde el estado; bit 31 = final */
+};
+
+/**
+ * @brief Arista del autómata.
+ */
+struct DawgEdge {
+    uint32_t target;  /**< Estado destino (bits 5..31) y símbolo (bits 0..4) */
+    uint32_t before;  /**< Palabras aceptadas antes de esta arista desde el estado */
+};
+
+/**
+ * @brief Posición en el autómata tras leer un prefijo.
+ *
+ * `index` es la cantidad de palabras menores que el prefijo, es decir el id
+ * de la primera palabra que lo extiende es `index + 1`. Una posición con
+ * `state == 0` indica que el prefijo no existe.
+ */
+struct DawgPos {
+    uint32_t state;   /**< Estado actual (0 = nulo) */
+    uint32_t index;   /**< Palabras lexicográficamente menores que el prefijo */
+
+    explicit operator bool() const { return state != 0; }
+};
+
+/**
+ * @brief Diccionario fijo con prioridades mutables por id de palabra.
+ *
+ * Las palabras no cambian después de construir; las prioridades sí, con la
+ * misma regla que `Trie` (FREQUENCY, RECENT o DECAYED). Los símbolos son los de
+ * `charToIndex`, igual que en `Trie`, así que ambos reconocen los mismos
+ * prefijos y dos palabras con el mismo camino cuentan como una.
+ */
+class Dawg {
+    public:
+    /**
+     * @brief Construye un diccionario vacío.
+     * @param variant_mode Variante de autocompletado: 0 = FREQUENCY, 1 = RECENT, 2 = DECAYED
+     */
+    Dawg(int variant_mode);
+
+    /**
+     * @brief Construye el autómata con las palabras de `t` y sus prioridades.
+     * @param t Trie de origen; no se modifica.
+     */
+    explicit Dawg(const Trie& t);
+
+    Dawg(const Dawg&) = delete;
+    Dawg& operator=(const Dawg&) = delete;
+
+    int variant; /**< Variante activa del autocompletado (FREQUENCY/RECENT/DECAYED) */
+
+    /**
+     * @brief Construye el autómata mínimo (reemplaza el contenido anterior).
+     *
+     * Las palabras se ordenan por símbolo y se agregan con el algoritmo
+     * incremental de Daciuk et al.: cuando una rama deja de ser el camino
+     * de la última palabra ya no cambia, y se reemplaza por un estado
+     * equivalente registrado o se registra. Si dos palabras tienen el mismo
+     * camino se conserva la primera.
+     *
+     * @param palabras Palabras, en cualquier orden.
+     * @param prioridades Prioridad inicial de cada palabra (vacío = 0).
+     */
+    void build(const vector<string_view>& palabras, const vector<uint32_t>& prioridades = {});
+
+    /**
+     * @brief Devuelve la posición de la raíz (prefijo vacío).
+     */
+    DawgPos get_root() const { return DawgPos{root, 0}; }
+
+    /**
+     * @brief Avanza un carácter desde la posición `p`.
+     * @param p Posición de partida.
+     * @param c Carácter a seguir.
+     * @return Nueva posición (nula si no existe la rama).
+     */
+    DawgPos descend(DawgPos p, const char c) const;
+
+    /**
+     * @brief Mejor completación del prefijo de `p`.
+     *
+     * Igual que `Trie::autocomplete`, considera las extensiones estrictas del
+     * prefijo con prioridad mayor que 0. En empates gana el id menor.
+     *
+     * @param p Posición desde la cual se consulta.
+     * @return Id de la palabra sugerida o 0 si no hay.
+     */
+    uint32_t autocomplete(DawgPos p) const;
+
+    /**
+     * @brief Indica si la posición corresponde a una palabra completa.
+     */
+    bool is_terminal(DawgPos p) const { return p.state && (states[p.state].words >> 31); }
+
+    /**
+     * @brief Id de la palabra de una posición terminal (0 si no es terminal).
+     */
+    uint32_t word_id(DawgPos p) const { return is_terminal(p) ? p.index + 1 : 0; }
+
+    /**
+     * @brief Id de una palabra (0 si no está).
+     */
+    uint32_t lookup(string_view w) const;
+
+    /**
+     * @brief Actualiza la prioridad de la palabra `id` según la variante.
+     * @param id Id de palabra (sin efecto si es 0).
+     */
+    void update_priority(uint32_t id);
+
+    /**
+     * @brief Prioridad actual de la palabra `id`.
+     */
+    uint32_t get_priority(uint32_t id) const { return priorities[id]; }
+
+    /**
+     * @brief Palabra de un id.
+     * @return Palabra o cadena vacía si `id` es 0.
+     */
+    string_view get_word(uint32_t id) const {
+        return id ? string_view(chars.data() + offsets[id - 1], offsets[id] - offsets[id - 1]) : string_view();
+    }
+
+    /**
+     * @brief Igual que `get_word` pero copiando la palabra.
+     */
+    string get_str(uint32_t id) const { return string(get_word(id)); }
+
+    /** @brief Cantidad de estados (sin contar el 0 reservado). */
+    uint32_t get_size() const { return (uint32_t)states.size() - 2; }
+
+    /** @brief Cantidad de aristas. */
+    uint32_t get_edges() const { return (uint32_t)edges.size(); }
+
+    /** @brief Cantidad de palabras. */
+    uint32_t get_words() const { return (uint32_t)offsets.size() - 1; }
+
+    /** @brief Bytes del autómata (estados y aristas). */
+    size_t automaton_bytes() const { return states.size() * sizeof(DawgState) + edges.size() * sizeof(DawgEdge); }
+
+    /** @brief Bytes de los arreglos por id: prioridades y árbol de segmentos. */
+    size_t side_bytes() const { return (priorities.size() + best.size()) * sizeof(uint32_t); }
+
+    /** @brief Bytes de las palabras y sus desplazamientos. */
+    size_t words_bytes() const { return chars.size() + offsets.size() * sizeof(uint32_t); }
+
+    /**
+     * @brief Devuelve la memoria total ocupada.
+     * @return Cantidad de bytes.
+     */
+    size_t memory_bytes() const { return automaton_bytes() + side_bytes() + words_bytes(); }
+
+private:
+    vector<DawgState> states;      /**< Estados; el 0 es nulo y el último es un centinela */
+    vector<DawgEdge> edges;        /**< Aristas de todos los estados, contiguas por estado */
+    uint32_t root;                 /**< Estado inicial */
+
+    vector<char> chars;            /**< Palabras concatenadas en orden de id */
+    vector<uint32_t> offsets;      /**< Inicio de cada palabra en `chars` (más el final) */
+    vector<uint32_t> priorities;   /**< Prioridad por id (el 0 no se usa) */
+    vector<uint32_t> best;         /**< Árbol de segmentos: id de máxima prioridad por rango */
+    uint32_t leaves;               /**< Hojas del árbol (una por id, más el 0) */
+
+    uint32_t global_counter;       /**< Contador usado por la variante RECENT */
+
+    uint32_t better(uint32_t a, uint32_t b) const;
+    void build_best();
+};
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file durable_trie.cpp
+ * @brief Recuperación, registro y compactación de `DurableTrie`.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#include "durable_trie.hpp"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+/**
+ * @brief True si el archivo existe y se puede leer.
+ */
+static bool existe(const string& ruta) {
+    ifstream f(ruta, ios::binary);
+    return f.good();
+}
+
+/**
+ * @brief True si el archivo existe y está vacío.
+ */
+static bool vacio(const string& ruta) {
+    ifstream f(ruta, ios::binary | ios::ate);
+    return f.good() && f.tellg() == 0;
+}
+
+/**
+ * @brief Recupera el estado: snapshot de la generación vigente y luego cada
+ * segmento desde esa generación en orden, hasta el primero que falte.
+ *
+ * El segmento activo es uno nuevo, posterior a los repetidos: si el último
+ * terminaba en un registro cortado, lo que se agregue no queda detrás de esa
+ * basura. Sólo se reutiliza el último si quedó vacío.
+ */
+DurableTrie::DurableTrie(const string& ruta, int variant_mode, int layout_mode, uint64_t compactar_cada)
+    : path(ruta), live(variant_mode, layout_mode), base(0), segment(0), since_compact(0),
+      compact_every(compactar_cada), replayed(0), fresh(true), compacting(false) {
+    ifstream manifiesto(manifest_path());
+    uint64_t g = 0;
+    if (manifiesto >> g) fresh = false;
+    base = g;
+
+    if (existe(snapshot_path(g))) {
+        live.load(snapshot_path(g));
+        fresh = false;
+    }
+
+    uint64_t s = g;
+    for (; existe(segment_path(s)); ++s) {
+        replayed += PriorityLog::replay(segment_path(s), [&](LogEvent tipo, string_view w) { apply(live, tipo, w); });
+        fresh = false;
+    }
+    if (s > g && vacio(segment_path(s - 1))) --s;
+    open_segment(s);
+}
+
+DurableTrie::~DurableTrie() {
+    if (compactor.joinable()) compactor.join();
+    log.reset();
+}
+
+/**
+ * @brief Repite un evento: `insert` tal cual; un uso busca el nodo de la
+ * palabra (ya terminal cuando se registró) y actualiza su prioridad; un
+ * bigrama busca las dos palabras y lo vuelve a observar; la activación de
+ * sucesores vuelve a activarlos con la misma capacidad.
+ */
+void DurableTrie::apply(Trie& t, LogEvent tipo, string_view w) {
+    if (tipo == LOG_INSERT) {
+        t.insert(w);
+        return;
+    }
+    if (tipo == LOG_SUCCESSORS) {
+        t.enable_successors((uint32_t)stoul(string(w)));
+        return;
+    }
+    if (tipo == LOG_NEXT) {
+        size_t espacio = w.find(' ');
+        if (espacio == string_view::npos) return;
+        t.observe_successor(t.find_prefix(w.substr(0, espacio)), t.find_prefix(w.substr(espacio + 1)));
+        return;
+    }
+    TrieNode* v = t.get_root();
+    for (char c : w) {
+        v = t.descend(v, c);
+        if (!v) return;
+    }
+    t.update_priority(v);
+}
+
+void DurableTrie::discard(const string& ruta) {
+    ifstream manifiesto(ruta + ".manifest");
+    uint64_t g = 0;
+    manifiesto >> g;
+    manifiesto.close();
+
+    remove((ruta + "." + to_string(g) + ".trie").c_str());
+    for (uint64_t s = g; remove((ruta + "." + to_string(s) + ".wal").c_str()) == 0; ++s) {}
+    remove((ruta + ".manifest").c_str());
+}
+
+TrieNode* DurableTrie::insert(string_view w) {
+    log->append(LOG_INSERT, w);
+    TrieNode* v = live.insert(w);
+    logged();
+    return v;
+}
+
+void DurableTrie::update_priority(TrieNode* v) {
+    if (!v || !live.is_terminal(v)) return;
+    log->append(LOG_USE, live.get_word(v));
+    live.update_priority(v);
+    logged();
+}
+
+void DurableTrie::enable_successors(uint32_t capacidad) {
+    log->append(LOG_SUCCESSORS, to_string(capacidad));
+    live.enable_successors(capacidad);
+    logged();
+}
+
+void DurableTrie::observe_successor(const TrieNode* anterior, const TrieNode* siguiente) {
+    if (!live.successor_table().capacity() || !live.is_terminal(anterior) || !live.is_terminal(siguiente)) return;
+    string par(live.get_word(anterior));
+    par += ' ';
+    par += live.get_word(siguiente);
+    log->append(LOG_NEXT, par);
+    live.observe_successor(anterior, siguiente);
+    logged();
+}
+
+/**
+ * @brief Cuenta un registro y lanza la compactación automática si toca.
+ *
+ * Si la anterior sigue en curso se deja pasar: el escritor nunca espera al
+ * hilo de compactación por esta vía. Tampoco lanza excepciones: el evento ya
+ * quedó registrado y aplicado, y el error de una compactación automática lo
+ * informan `compact`, `checkpoint` o `wait_compaction`.
+ */
+void DurableTrie::logged() {
+    if (compact_every == 0 || ++since_compact < compact_every || compacting) return;
+    start_compaction();
+}
+
+void DurableTrie::open_segment(uint64_t s) {
+    segment = s;
+    log = make_unique<PriorityLog>(segment_path(s));
+}
+
+/**
+ * @brief Deja `g` como generación vigente y borra lo que ya cubre su snapshot.
+ *
+ * El snapshot `g` ya está en disco; el manifiesto se escribe aparte y se
+ * reemplaza con rename, así una caída deja el manifiesto viejo (con todos
+ * sus segmentos intactos) o el nuevo, nunca uno a medias.
+ */
+void DurableTrie::publish(uint64_t g, uint64_t viejo, uint64_t hasta) {
+    string tmp = manifest_path() + ".tmp";
+    {
+        ofstream out(tmp, ios::trunc);
+        if (!out.is_open()) throw runtime_error("No se pudo abrir el archivo: " + tmp);
+        out << g << "\n";
+        out.close();
+        if (out.fail()) throw runtime_error("No se pudo escribir el archivo: " + tmp);
+    }
+    sincronizarArchivo(tmp);
+    reemplazarArchivo(tmp, manifest_path());
+    base = g;
+
+    if (viejo != g) remove(snapshot_path(viejo).c_str());
+    for (uint64_t s = viejo; s <= hasta; ++s) remove(segment_path(s).c_str());
+}
+
+/**
+ * @brief Guarda el Trie en uso como generación `segment + 1`.
+ *
+ * Se cierra el segmento activo antes de guardar: si la caída ocurre antes de
+ * cambiar el manifiesto, la generación anterior más sus segmentos siguen
+ * describiendo el mismo estado.
+ */
+void DurableTrie::checkpoint() {
+    wait_compaction();
+    uint64_t hasta = segment;
+    uint64_t g = hasta + 1;
+    log.reset();
+
+    string tmp = snapshot_path(g) + ".tmp";
+    live.save(tmp);
+    sincronizarArchivo(tmp);
+    reemplazarArchivo(tmp, snapshot_path(g));
+    publish(g, base, hasta);
+
+    since_compact = 0;
+    open_segment(g);
+}
+
+void DurableTrie::compact() {
+    wait_compaction();
+    start_compaction();
+}
+
+/**
+ * @brief Cierra el segmento activo y lanza el hilo de compactación (la
+ * anterior ya terminó; su error, si lo hubo, queda guardado).
+ */
+void DurableTrie::start_compaction() {
+    if (compactor.joinable()) compactor.join();
+    uint64_t hasta = segment;
+    log.reset();               // el segmento cerrado queda completo en disco
+    open_segment(hasta + 1);
+    since_compact = 0;
+
+    compacting = true;
+    compactor = thread([this, g = hasta + 1, viejo = base.load(), hasta]() { run_compaction(g, viejo, hasta); });
+}
+
+void DurableTrie::wait_compaction() {
+    if (compactor.joinable()) compactor.join();
+    if (!compact_error.empty()) {
+        string error = compact_error;
+        compact_error.clear();
+        throw runtime_error("Falló la compactación: " + error);
+    }
+}
+
+/**
+ * @brief (Hilo de compactación) Snapshot `viejo` + segmentos `viejo..hasta`
+ * en un Trie aparte, guardado como generación `g`.
+ *
+ * Si algo falla, los archivos de la generación vieja quedan intactos y la
+ * próxima compactación vuelve a partir de ellos.
+ */
+void DurableTrie::run_compaction(uint64_t g, uint64_t viejo, uint64_t hasta) {
+    try {
+        Trie t(live.variant, live.layout);
+        if (existe(snapshot_path(viejo))) t.load(snapshot_path(viejo));
+        for (uint64_t s = viejo; s <= hasta; ++s) {
+            if (!existe(segment_path(s))) continue;
+            PriorityLog::replay(segment_path(s), [&](LogEvent tipo, string_view w) { apply(t, tipo, w); });
+        }
+
+        string tmp = snapshot_path(g) + ".tmp";
+        t.save(tmp);
+        sincronizarArchivo(tmp);
+        reemplazarArchivo(tmp, snapshot_path(g));
+        publish(g, viejo, hasta);
+    } catch (const exception& e) {
+        compact_error = e.what();
+    }
+    compacting = false;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file durable_trie.hpp
+ * @brief Trie cuyas prioridades aprendidas sobreviven al cierre y a caídas.
+ *
+ * El estado en disco es un snapshot base (`Trie::save`) más una secuencia de
+ * segmentos de log (`PriorityLog`) con los `insert`/`update_priority`/
+ * `enable_successors`/`observe_successor` posteriores. Al abrir se carga el
+ * snapshot y se repiten sólo los segmentos, así que recuperar cuesta
+ * O(actualizaciones recientes) y no O(corpus).
+ *
+ * Archivos, para una ruta base `R` y una generación `G`:
+ *   - `R.manifest`: número de la generación vigente (se reemplaza con rename).
+ *   - `R.G.trie`: snapshot base de la generación (puede no existir si G = 0).
+ *   - `R.G.wal`, `R.(G+1).wal`, ...: segmentos a repetir sobre el snapshot.
+ *
+ * La compactación cierra el segmento activo y, en un hilo aparte, arma un
+ * Trie propio a partir del snapshot y los segmentos cerrados, lo guarda como
+ * la generación siguiente y cambia el manifiesto. El Trie en uso no se toca,
+ * por lo que las consultas y actualizaciones siguen mientras se compacta.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef DURABLE_TRIE_HPP
+#define DURABLE_TRIE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "trie.hpp"
+#include "wal.hpp"
+
+using namespace std;
+
+/**
+ * @brief Trie con log de actualizaciones y snapshots compactados.
+ *
+ * Expone la misma interfaz por carácter que `Trie`, de modo que `recorrer`
+ * y la GUI pueden usarlo sin cambios. Pensado para un solo hilo escritor.
+ */
+class DurableTrie {
+public:
+    /**
+     * @brief Abre (o crea) el estado guardado en `ruta` y lo recupera.
+     * @param ruta Ruta base de los archivos.
+     * @param variant_mode Variante si no hay snapshot (FREQUENCY/RECENT/DECAYED).
+     * @param layout_mode Layout de hijos si no hay snapshot.
+     * @param compactar_cada Registros de log que disparan una compactación
+     *        en segundo plano (0 = sólo manual).
+     */
+    DurableTrie(const string& ruta, int variant_mode, int layout_mode = ADAPTIVE_LAYOUT,
+                uint64_t compactar_cada = 1 << 20);
+
+    /** @brief Espera la compactación en curso y deja el log en disco. */
+    ~DurableTrie();
+
+    DurableTrie(const DurableTrie&) = delete;
+    DurableTrie& operator=(const DurableTrie&) = delete;
+
+    /** @brief Inserta una palabra y registra el evento. */
+    TrieNode* insert(string_view w);
+
+    /** @brief Actualiza la prioridad de un terminal y registra el evento. */
+    void update_priority(TrieNode* v);
+
+    /**
+     * @brief Activa las tablas de sucesores (ver `Trie::enable_successors`) y
+     * lo registra, para que la recuperación y la compactación las activen
+     * antes de repetir los bigramas aunque no haya snapshot.
+     * @param capacidad Sucesores por palabra (0 = desactivadas).
+     */
+    void enable_successors(uint32_t capacidad);
+    /** @brief Registra que la palabra de `siguiente` se usó después de la de `anterior`. */
+    void observe_successor(const TrieNode* anterior, const TrieNode* siguiente);
+
+    TrieNode* get_root() { return live.get_root(); }
+    TrieNode* descend(TrieNode* v, const char c) { return live.descend(v, c); }
+    TrieNode* autocomplete(TrieNode* v) { return live.autocomplete(v); }
+    vector<TrieNode*> fuzzy_autocomplete(string_view p, uint32_t max_edits, uint32_t k) { return live.fuzzy_autocomplete(p, max_edits, k); }
+    vector<TrieNode*> predict_next(const TrieNode* v, uint32_t k = 1) { return live.predict_next(v, k); }
+    bool is_terminal(const TrieNode* v) const { return live.is_terminal(v); }
+    string_view get_word(const TrieNode* v) const { return live.get_word(v); }
+    string get_str(const TrieNode* v) const { return live.get_str(v); }
+
+    /**
+     * @brief Trie en memoria. Modificarlo directamente no queda registrado
+     * (útil para una carga inicial seguida de `checkpoint`).
+     */
+    Trie& trie() { return live; }
+
+    /** @brief Espera a que todo lo registrado hasta ahora esté en disco. */
+    void sync() { log->sync(); }
+
+    /**
+     * @brief Guarda el Trie en uso como nueva generación, en este hilo.
+     *
+     * Se usa tras una carga inicial hecha con `trie()`, que no pasa por el log.
+     */
+    void checkpoint();
+
+    /**
+     * @brief Cierra el segmento activo y compacta en segundo plano.
+     *
+     * Si ya hay una compactación en curso, primero la espera.
+     */
+    void compact();
+
+    /**
+     * @brief Espera la compactación en curso. Relanza el error de una
+     * compactación anterior (manual o automática) que aún no se informó.
+     */
+    void wait_compaction();
+
+    /** @brief True si al abrir no había estado previo (ni snapshot ni log). */
+    bool is_new() const { return fresh; }
+
+    /** @brief Registros repetidos al abrir. */
+    uint64_t replayed_records() const { return replayed; }
+
+    /** @brief Generación vigente en el manifiesto. */
+    uint64_t generation() const { return base; }
+
+    /** @brief Log activo (para métricas de group commit). */
+    PriorityLog& active_log() { return *log; }
+
+    /**
+     * @brief Aplica un evento del log a un Trie.
+     * @param t Trie destino.
+     * @param tipo Tipo de evento.
+     * @param w Palabra.
+     */
+    static void apply(Trie& t, LogEvent tipo, string_view w);
+
+    /**
+     * @brief Borra el estado guardado en `ruta` (manifiesto, snapshot y
+     * segmentos de la generación vigente).
+     * @param ruta Ruta base de los archivos.
+     */
+    static void discard(const string& ruta);
+
+private:
+    string path;
+    Trie live;                       /**< Trie en uso */
+    unique_ptr<PriorityLog> log;     /**< Segmento activo */
+    atomic<uint64_t> base;           /**< Generación del snapshot base */
+    uint64_t segment;                /**< Número del segmento activo */
+    uint64_t since_compact;          /**< Registros desde la última compactación */
+    uint64_t compact_every;          /**< Umbral de compactación automática */
+    uint64_t replayed;               /**< Registros repetidos al abrir */
+    bool fresh;                      /**< Sin estado previo al abrir */
+
+    thread compactor;                /**< Hilo de la compactación en curso */
+    atomic<bool> compacting;         /**< True mientras el hilo trabaja */
+    string compact_error;            /**< Error de la última compactación */
+
+    string snapshot_path(uint64_t g) const { return path + "." + to_string(g) + ".trie"; }
+    string segment_path(uint64_t s) const { return path + "." + to_string(s) + ".wal"; }
+    string manifest_path() const { return path + ".manifest"; }
+
+    void logged();
+    void start_compaction();
+    void open_segment(uint64_t s);
+    void publish(uint64_t g, uint64_t viejo, uint64_t hasta);
+    void run_compaction(uint64_t g, uint64_t viejo, uint64_t hasta);
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file epoch.hpp
+ * @brief Recolección por épocas (EBR) para leer el Trie mientras otro hilo escribe.
+ *
+ * El escritor no libera de inmediato lo que deja de estar enlazado (por
+ * ejemplo, un bloque de hijos reemplazado por su copia): lo retira anotando
+ * la época global. Cada lector anuncia la época en que empezó una consulta y
+ * la borra al terminar. Un objeto retirado en la época `e` se puede reutilizar
+ * cuando la época global llega a `e + 2`, porque para avanzar dos veces todos
+ * los lectores activos tuvieron que pasar por una época posterior al retiro.
+ *
+ * Entrar y salir de una consulta son dos escrituras, sin esperas: los lectores
+ * nunca bloquean al escritor ni entre sí (a lo más retrasan la reutilización).
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Época global y épocas anunciadas por los lectores.
+ */
+class EpochManager {
+public:
+    static constexpr unsigned MAX_LECTORES = 64;   /**< Lectores simultáneos registrados */
+
+    EpochManager() : global(1) {
+        for (Slot& s : slots) {
+            s.epoch.store(0, memory_order_relaxed);
+            s.used.store(false, memory_order_relaxed);
+        }
+    }
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Reserva un slot para un hilo lector.
+     * @return Índice del slot.
+     */
+    unsigned join() {
+        for (unsigned i = 0; i < MAX_LECTORES; ++i) {
+            bool libre = false;
+            if (slots[i].used.compare_exchange_strong(libre, true, memory_order_acq_rel)) return i;
+        }
+        throw runtime_error("No hay slots de lector disponibles");
+    }
+
+    /** @brief Libera el slot de un lector (fuera de toda consulta). */
+    void leave(unsigned s) {
+        slots[s].epoch.store(0, memory_order_release);
+        slots[s].used.store(false, memory_order_release);
+    }
+
+    /**
+     * @brief Inicio de una consulta: anuncia la época actual.
+     *
+     * La barrera asegura que el anuncio sea visible antes de cualquier lectura
+     * del Trie. Si la época leída ya quedó atrás, el anuncio sólo frena el
+     * avance de la época, lo que sigue siendo seguro.
+     */
+    void enter(unsigned s) {
+        slots[s].epoch.store(global.load(memory_order_relaxed), memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+
+    /** @brief Fin de una consulta. */
+    void exit(unsigned s) { slots[s].epoch.store(0, memory_order_release); }
+
+    /**
+     * @brief (Escritor) Avanza la época si todos los lectores activos ya
+     * anunciaron la actual.
+     * @return Época global resultante.
+     */
+    uint64_t try_advance() {
+        atomic_thread_fence(memory_order_seq_cst);
+        uint64_t g = global.load(memory_order_relaxed);
+        for (const Slot& s : slots) {
+            uint64_t e = s.epoch.load(memory_order_acquire);
+            if (e != 0 && e != g) return g;
+        }
+        global.store(g + 1, memory_order_release);
+        return g + 1;
+    }
+
+    /** @brief Época global actual. */
+    uint64_t current() const { return global.load(memory_order_acquire); }
+
+private:
+    /** @brief Época anunciada por un lector (0 = fuera de consulta). */
+    struct alignas(64) Slot {
+        atomic<uint64_t> epoch;
+        atomic<bool> used;
+    };
+
+    alignas(64) atomic<uint64_t> global;   /**< Época global */
+    Slot slots[MAX_LECTORES];              /**< Un slot por lector, en líneas de caché separadas */
+};
+
+/**
+ * @brief Registro de un hilo lector mientras exista el objeto.
+ */
+class EpochReader {
+public:
+    explicit EpochReader(EpochManager& m) : manager(m), slot(m.join()) {}
+    ~EpochReader() { manager.leave(slot); }
+
+    EpochReader(const EpochReader&) = delete;
+    EpochReader& operator=(const EpochReader&) = delete;
+
+    EpochManager& manager;   /**< Manager donde se registró */
+    unsigned slot;           /**< Slot reservado */
+};
+
+/**
+ * @brief Delimita una consulta: mientras exista, nada de lo que el lector
+ * alcance se reutiliza.
+ */
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochReader& r) : reader(r) { r.manager.enter(r.slot); }
+    ~EpochGuard() { reader.manager.exit(reader.slot); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    EpochReader& reader;
+};
+
+#endif
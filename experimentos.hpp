@@ -0,0 +1,1791 @@
+/**
+ * @file experimentos.hpp
+ * @brief Experimentos de rendimiento sobre las distintas variantes del Trie.
+ *
+ * Cada función lee un dataset, construye las estructuras a comparar e imprime
+ * los resultados en consola en los puntos de control 2^i, igual que
+ * `cargarArchivoPalabras`.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef EXPERIMENTOS_HPP
+#define EXPERIMENTOS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "trie.hpp"
+#include "radix_trie.hpp"
+#include "utils.hpp"
+#include "tokenizer.hpp"
+#include "durable_trie.hpp"
+#include "louds_trie.hpp"
+#include "dawg.hpp"
+#include "overlay.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Mide la latencia promedio de `descend` sobre una muestra de palabras.
+ *
+ * Recorre cada palabra de la muestra desde la raíz, repitiendo hasta acumular
+ * suficientes pasos para que el tiempo sea medible.
+ *
+ * @param trie Trie a consultar.
+ * @param muestra Palabras a recorrer.
+ * @return Nanosegundos promedio por llamada a `descend`.
+ */
+inline double medirDescenso(Trie& trie, const vector<string>& muestra) {
+    uint64_t pasos = 0;
+    uintptr_t checksum = 0;
+    auto start = chrono::high_resolution_clock::now();
+    while (pasos < 2000000) {
+        for (const string& palabra : muestra) {
+            TrieNode* node = trie.get_root();
+            for (char c : palabra) {
+                node = trie.descend(node, c);
+                pasos++;
+            }
+            checksum += (uintptr_t)node;
+        }
+    }
+    auto end = chrono::high_resolution_clock::now();
+    if (checksum == 1) cout << "";  // evita que se elimine el recorrido
+    return chrono::duration<double, nano>(end - start).count() / pasos;
+}
+
+/**
+ * @brief Compara el layout fijo (27 hijos por nodo) con el adaptativo.
+ *
+ * Inserta el dataset en ambos Tries a la vez y en cada punto de control 2^i
+ * informa bytes por palabra y latencia de `descend` de cada layout.
+ *
+ * @param rutaArchivo Ruta del archivo de palabras.
+ */
+inline void compararLayouts(const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo);
+
+    if (!archivo.is_open()) {
+        throw runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+
+    Trie fijo(FREQUENCY, FIXED_LAYOUT);
+    Trie adaptativo(FREQUENCY, ADAPTIVE_LAYOUT);
+    vector<string> palabras;
+    string palabra;
+    int e = 0;
+
+    while (archivo >> palabra) {
+        fijo.insert(palabra);
+        adaptativo.insert(palabra);
+        palabras.push_back(palabra);
+
+        if (palabras.size() == (1ULL << e)) {
+            // muestra de hasta 4096 palabras repartidas entre las insertadas
+            vector<string> muestra;
+            size_t paso = max<size_t>(1, palabras.size() / 4096);
+            for (size_t k = 0; k < palabras.size(); k += paso) muestra.push_back(palabras[k]);
+
+            double n = (double)palabras.size();
+            cout << "2^" << e << " palabras"
+                 << " | fijo: " << fijo.memory_bytes() / n << " B/palabra, "
+                 << medirDescenso(fijo, muestra) << " ns/descend"
+                 << " | adaptativo: " << adaptativo.memory_bytes() / n << " B/palabra, "
+                 << medirDescenso(adaptativo, muestra) << " ns/descend\n";
+            e++;
+        }
+    }
+
+    archivo.close();
+    cout << " === === \n";
+}
+
+/**
+ * @brief Inserta todas las palabras de un archivo sin imprimir progreso.
+ *
+ * @param trie Estructura donde se insertan las palabras (`Trie` o `RadixTrie`).
+ * @param rutaArchivo Ruta del archivo de palabras.
+ * @return Cantidad de palabras leídas.
+ */
+template <typename T>
+inline uint64_t cargarSilencioso(T& trie, const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo);
+
+    if (!archivo.is_open()) {
+        throw runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+
+    uint64_t n = 0;
+    string palabra;
+    while (archivo >> palabra) {
+        trie.insert(palabra);
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Entrena prioridades sin imprimir: inserta cada palabra del texto y
+ * actualiza su prioridad como si el usuario la hubiera escrito.
+ *
+ * @param trie Estructura a entrenar.
+ * @param rutaArchivo Ruta del texto.
+ * @return Cantidad de palabras procesadas.
+ */
+template <typename T>
+inline uint64_t entrenarSilencioso(T& trie, const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo);
+
+    if (!archivo.is_open()) {
+        throw runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+
+    uint64_t n = 0;
+    string palabra;
+    while (archivo >> palabra) {
+        trie.update_priority(trie.insert(palabra));
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Lee hasta `maximo` palabras repartidas uniformemente en un archivo.
+ *
+ * @param rutaArchivo Ruta del archivo.
+ * @param maximo Cantidad máxima de palabras de la muestra.
+ * @return Palabras de la muestra.
+ */
+inline vector<string> muestraPalabras(const string& rutaArchivo, size_t maximo) {
+    ifstream archivo(rutaArchivo);
+
+    if (!archivo.is_open()) {
+        throw runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+
+    vector<string> todas;
+    string palabra;
+    while (archivo >> palabra) todas.push_back(palabra);
+
+    vector<string> muestra;
+    size_t paso = max<size_t>(1, todas.size() / maximo);
+    for (size_t k = 0; k < todas.size() && muestra.size() < maximo; k += paso) {
+        muestra.push_back(todas[k]);
+    }
+    return muestra;
+}
+
+/**
+ * @brief Compara el Trie normal con el Trie comprimido (radix).
+ *
+ * Construye ambos con el diccionario, informa nodos y memoria, y luego
+ * simula la escritura del texto con `recorrer` en cada uno, reportando tiempo
+ * y pasos promedio de propagación por actualización de prioridad.
+ *
+ * @param rutaPalabras Diccionario inicial.
+ * @param rutaTexto Texto a simular.
+ * @param variante Variante de prioridad (FREQUENCY o RECENT).
+ */
+inline void compararCompresion(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    RadixTrie radix(variante);
+
+    uint64_t n = cargarSilencioso(trie, rutaPalabras);
+    cargarSilencioso(radix, rutaPalabras);
+
+    cout << "Palabras: " << n << "\n";
+    cout << "Trie:  " << trie.get_size() << " nodos, " << trie.memory_bytes() << " bytes\n";
+    cout << "Radix: " << radix.get_size() << " nodos, " << radix.memory_bytes() << " bytes\n";
+
+    auto start1 = chrono::high_resolution_clock::now();
+    recorrer(trie, rutaTexto);
+    auto end1 = chrono::high_resolution_clock::now();
+
+    auto start2 = chrono::high_resolution_clock::now();
+    recorrer(radix, rutaTexto);
+    auto end2 = chrono::high_resolution_clock::now();
+
+    cout << "Trie:  " << trie.get_size() << " nodos, "
+         << chrono::duration<double>(end1 - start1).count() << " segundos, "
+         << trie.get_propagation_steps() << " pasos de propagacion\n";
+    cout << "Radix: " << radix.get_size() << " nodos, "
+         << chrono::duration<double>(end2 - start2).count() << " segundos, "
+         << radix.get_propagation_steps() << " pasos de propagacion\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara `autocomplete_topk` (listas por nodo) contra recorrer el subárbol.
+ *
+ * Entrena prioridades con el texto y consulta las `k` mejores sugerencias
+ * para todos los prefijos de una muestra del diccionario, informando tiempo
+ * promedio por consulta, memoria de las listas y cuántas respuestas difieren
+ * (se comparan las prioridades, ya que los empates pueden ordenarse distinto).
+ *
+ * @param rutaPalabras Diccionario inicial.
+ * @param rutaTexto Texto para entrenar prioridades.
+ * @param variante Variante de prioridad (FREQUENCY o RECENT).
+ * @param k Cantidad de sugerencias por consulta.
+ */
+inline void compararTopK(const string& rutaPalabras, const string& rutaTexto, int variante, uint32_t k) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    trie.enable_topk(k);
+    entrenarSilencioso(trie, rutaTexto);
+
+    vector<TrieNode*> prefijos;
+    for (const string& palabra : muestraPalabras(rutaPalabras, 2000)) {
+        TrieNode* node = trie.get_root();
+        for (char c : palabra) {
+            node = trie.descend(node, c);
+            if (!node) break;
+            prefijos.push_back(node);
+        }
+    }
+
+    size_t total_listas = 0, total_scan = 0, distintas = 0;
+    vector<vector<TrieNode*>> r_listas, r_scan;
+
+    auto start1 = chrono::high_resolution_clock::now();
+    for (TrieNode* node : prefijos) {
+        r_listas.push_back(trie.autocomplete_topk(node, k));
+        total_listas += r_listas.back().size();
+    }
+    auto end1 = chrono::high_resolution_clock::now();
+
+    auto start2 = chrono::high_resolution_clock::now();
+    for (TrieNode* node : prefijos) {
+        r_scan.push_back(trie.autocomplete_topk_scan(node, k));
+        total_scan += r_scan.back().size();
+    }
+    auto end2 = chrono::high_resolution_clock::now();
+
+    // iterador perezoso: primera página de k resultados
+    size_t distintas_iter = 0;
+    auto start3 = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < prefijos.size(); ++i) {
+        CompletionIterator it(trie, prefijos[i], k);
+        size_t j = 0;
+        for (TrieNode* t = it.next(); t; t = it.next(), ++j) {
+            if (j >= r_scan[i].size() || t->priority != r_scan[i][j]->priority) {
+                distintas_iter++;
+                break;
+            }
+        }
+    }
+    auto end3 = chrono::high_resolution_clock::now();
+
+    for (size_t i = 0; i < prefijos.size(); ++i) {
+        bool igual = r_listas[i].size() == r_scan[i].size();
+        for (size_t j = 0; igual && j < r_listas[i].size(); ++j) {
+            igual = r_listas[i][j]->priority == r_scan[i][j]->priority;
+        }
+        if (!igual) distintas++;
+    }
+
+    double n = (double)prefijos.size();
+    cout << "Consultas: " << prefijos.size() << " prefijos, k = " << k << "\n";
+    cout << "Listas top-k: " << chrono::duration<double, micro>(end1 - start1).count() / n
+         << " us/consulta, " << trie.topk_bytes() << " bytes extra ("
+         << (double)trie.topk_bytes() / trie.memory_bytes() * 100 << "% del trie)\n";
+    cout << "Recorrido del subarbol: " << chrono::duration<double, micro>(end2 - start2).count() / n
+         << " us/consulta\n";
+    cout << "Iterador perezoso (primera pagina): " << chrono::duration<double, micro>(end3 - start3).count() / n
+         << " us/consulta | consultas con resultado distinto: " << distintas_iter << "\n";
+    cout << "Sugerencias: " << total_listas << " vs " << total_scan
+         << " | consultas con resultado distinto: " << distintas << "\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara el throughput de lectura con `ifstream >> string` y con `Tokenizer`.
+ *
+ * Sólo separa palabras (sin insertar) y verifica que ambos lectores vean la
+ * misma cantidad de palabras y caracteres.
+ *
+ * @param rutaArchivo Ruta del archivo.
+ */
+inline void compararLectura(const string& rutaArchivo) {
+    uint64_t palabras1 = 0, chars1 = 0, palabras2 = 0, chars2 = 0;
+
+    auto start1 = chrono::high_resolution_clock::now();
+    {
+        ifstream archivo(rutaArchivo);
+        if (!archivo.is_open()) {
+            throw runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+        }
+        string palabra;
+        while (archivo >> palabra) {
+            palabras1++;
+            chars1 += palabra.size();
+        }
+    }
+    auto end1 = chrono::high_resolution_clock::now();
+
+    uint64_t bytes;
+    auto start2 = chrono::high_resolution_clock::now();
+    {
+        Tokenizer tokens(rutaArchivo);
+        string_view palabra;
+        while (tokens.next(palabra)) {
+            palabras2++;
+            chars2 += palabra.size();
+        }
+        bytes = tokens.size();
+    }
+    auto end2 = chrono::high_resolution_clock::now();
+
+    double mb = bytes / 1e6;
+    cout << "ifstream >> string: " << mb / chrono::duration<double>(end1 - start1).count() << " MB/s ("
+         << palabras1 << " palabras, " << chars1 << " caracteres)\n";
+    cout << "Tokenizer (mmap):   " << mb / chrono::duration<double>(end2 - start2).count() << " MB/s ("
+         << palabras2 << " palabras, " << chars2 << " caracteres)\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide la normalización (minúsculas y puntuación) y su efecto en el Trie.
+ *
+ * Compara el throughput de `normalizarEscalar` contra `normalizarBloque`
+ * (SIMD), el de `Tokenizer` con y sin normalizar, y cuántos nodos y palabras
+ * fuera de a-z (que caen en el índice 26) quedan al insertar el texto.
+ *
+ * @param rutaArchivo Ruta del archivo.
+ */
+inline void compararNormalizacion(const string& rutaArchivo) {
+    {
+        MappedFile archivo(rutaArchivo);
+        const uint64_t bloque = 1ULL << 20;
+        vector<char> salida(bloque);
+        uint64_t total = archivo.size();
+        const char* datos = total ? archivo.map(0, total) : nullptr;
+
+        auto medir = [&](void (*f)(const char*, char*, size_t)) {
+            auto start = chrono::high_resolution_clock::now();
+            for (uint64_t off = 0; off < total; off += bloque) {
+                f(datos + off, salida.data(), (size_t)min(bloque, total - off));
+            }
+            chrono::duration<double> t = chrono::high_resolution_clock::now() - start;
+            return total / 1e6 / t.count();
+        };
+        cout << "Normalizacion escalar: " << medir(normalizarEscalar) << " MB/s\n";
+        cout << "Normalizacion SIMD:    " << medir(normalizarBloque) << " MB/s\n";
+    }
+
+    for (bool normalizar : {false, true}) {
+        Trie trie(RECENT);
+        Tokenizer tokens(rutaArchivo, normalizar);
+        string_view palabra;
+        uint64_t palabras = 0, con_extras = 0;
+
+        auto start = chrono::high_resolution_clock::now();
+        while (tokens.next(palabra)) {
+            palabras++;
+            for (char c : palabra) {
+                if (charToIndex(c) == 26) {
+                    con_extras++;
+                    break;
+                }
+            }
+            trie.insert(palabra);
+        }
+        chrono::duration<double> t = chrono::high_resolution_clock::now() - start;
+
+        cout << (normalizar ? "Normalizado: " : "Sin normalizar: ")
+             << tokens.size() / 1e6 / t.count() << " MB/s, "
+             << palabras << " palabras, " << con_extras << " con caracteres fuera de a-z, "
+             << trie.get_size() << " nodos\n";
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mapea un archivo completo y separa sus palabras.
+ * @param archivo Archivo abierto (las vistas son válidas mientras siga mapeado).
+ * @return Palabras en el orden del archivo.
+ */
+inline vector<string_view> separarPalabras(MappedFile& archivo) {
+    vector<string_view> palabras;
+    const char* datos = archivo.size() ? archivo.map(0, archivo.size()) : nullptr;
+    size_t n = (size_t)archivo.size(), i = 0;
+    while (i < n) {
+        while (i < n && esSeparador(datos[i])) i++;
+        size_t inicio = i;
+        while (i < n && !esSeparador(datos[i])) i++;
+        if (i > inicio) palabras.push_back(string_view(datos + inicio, i - inicio));
+    }
+    return palabras;
+}
+
+/**
+ * @brief Compara la carga palabra por palabra con `Trie::build_sorted`.
+ *
+ * Mide el arranque en frío (lectura + construcción) de una lista ordenada:
+ * - `insert` por palabra, como `cargarArchivoPalabras`.
+ * - `build_sorted` sobre las palabras del archivo mapeado.
+ * - Con prioridades: `insert` + `update_priority` (RECENT) contra
+ *   `build_sorted` con las mismas prioridades, verificando que ambos Tries
+ *   sugieran lo mismo en cada prefijo de una muestra.
+ *
+ * @param rutaArchivo Ruta de la lista de palabras (ordenada).
+ */
+inline void compararCargaOrdenada(const string& rutaArchivo) {
+    auto segundos = [](chrono::high_resolution_clock::time_point desde) {
+        return chrono::duration<double>(chrono::high_resolution_clock::now() - desde).count();
+    };
+
+    auto t1 = chrono::high_resolution_clock::now();
+    Trie incremental(RECENT);
+    {
+        Tokenizer tokens(rutaArchivo);
+        string_view palabra;
+        while (tokens.next(palabra)) incremental.insert(palabra);
+    }
+    double s1 = segundos(t1);
+
+    MappedFile archivo(rutaArchivo);
+    auto t2 = chrono::high_resolution_clock::now();
+    vector<string_view> palabras = separarPalabras(archivo);
+    Trie masivo(RECENT);
+    masivo.build_sorted(palabras);
+    double s2 = segundos(t2);
+
+    cout << "insert por palabra: " << s1 << " s, " << incremental.get_size() << " nodos, "
+         << incremental.memory_bytes() << " bytes\n";
+    cout << "build_sorted:       " << s2 << " s, " << masivo.get_size() << " nodos, "
+         << masivo.memory_bytes() << " bytes\n";
+
+    // con prioridades: la i-esima palabra usada en orden recibe i + 1 en RECENT
+    vector<uint32_t> prioridades(palabras.size());
+    for (size_t i = 0; i < palabras.size(); ++i) prioridades[i] = (uint32_t)(i + 1);
+
+    auto t3 = chrono::high_resolution_clock::now();
+    Trie usado(RECENT);
+    for (string_view p : palabras) usado.update_priority(usado.insert(p));
+    double s3 = segundos(t3);
+
+    auto t4 = chrono::high_resolution_clock::now();
+    Trie precargado(RECENT);
+    precargado.build_sorted(palabras, prioridades);
+    double s4 = segundos(t4);
+
+    uint64_t consultas = 0, iguales = 0;
+    size_t paso = max<size_t>(1, palabras.size() / 4096);
+    for (size_t k = 0; k < palabras.size(); k += paso) {
+        TrieNode* a = usado.get_root();
+        TrieNode* b = precargado.get_root();
+        for (char c : palabras[k]) {
+            a = usado.descend(a, c);
+            b = precargado.descend(b, c);
+            consultas++;
+            if (usado.get_word(usado.autocomplete(a)) == precargado.get_word(precargado.autocomplete(b))) iguales++;
+        }
+    }
+
+    cout << "insert + update_priority: " << s3 << " s\n";
+    cout << "build_sorted con prioridades: " << s4 << " s (" << iguales << "/" << consultas
+         << " sugerencias iguales)\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide `Trie::build_parallel` con distinta cantidad de hilos.
+ *
+ * Usa prioridades distintas por palabra para que no haya empates y verifica
+ * que la cantidad de nodos y las sugerencias de una muestra de prefijos
+ * coincidan con `build_sorted`.
+ *
+ * @param rutaArchivo Ruta de la lista de palabras.
+ */
+inline void compararConstruccionParalela(const string& rutaArchivo) {
+    MappedFile archivo(rutaArchivo);
+    vector<string_view> palabras = separarPalabras(archivo);
+    vector<uint32_t> prioridades(palabras.size());
+    for (size_t i = 0; i < palabras.size(); ++i) prioridades[i] = (uint32_t)(i + 1);
+
+    auto start = chrono::high_resolution_clock::now();
+    Trie secuencial(RECENT);
+    secuencial.build_sorted(palabras, prioridades);
+    double base = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    cout << "Nucleos disponibles: " << thread::hardware_concurrency() << "\n";
+    cout << "build_sorted: " << base << " s, " << secuencial.get_size() << " nodos\n";
+
+    for (unsigned hilos : {2u, 4u, 8u, 16u}) {
+        auto t = chrono::high_resolution_clock::now();
+        Trie paralelo(RECENT);
+        paralelo.build_parallel(palabras, prioridades, hilos);
+        double s = chrono::duration<double>(chrono::high_resolution_clock::now() - t).count();
+
+        uint64_t consultas = 0, iguales = 0;
+        size_t paso = max<size_t>(1, palabras.size() / 4096);
+        for (size_t k = 0; k < palabras.size(); k += paso) {
+            TrieNode* a = secuencial.get_root();
+            TrieNode* b = paralelo.get_root();
+            for (char c : palabras[k]) {
+                a = secuencial.descend(a, c);
+                b = paralelo.descend(b, c);
+                consultas++;
+                if (secuencial.get_word(secuencial.autocomplete(a)) == paralelo.get_word(paralelo.autocomplete(b))) iguales++;
+            }
+        }
+
+        cout << "build_parallel (" << hilos << " hilos): " << s << " s, speedup " << base / s << "x, "
+             << paralelo.get_size() << " nodos, " << iguales << "/" << consultas << " sugerencias iguales\n";
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Prueba de estrés: lectores concurrentes mientras un hilo escribe.
+ *
+ * Carga el diccionario, activa `set_concurrent` y lanza un escritor que
+ * recorre el texto en bucle con `insert` + `update_priority` (desde la
+ * segunda vuelta agrega un sufijo a cada palabra, para que siga creando
+ * nodos y reemplazando bloques de hijos). En paralelo, `lectores` hilos
+ * consultan `descend` + `autocomplete` sobre prefijos del diccionario y
+ * verifican que cada sugerencia extienda el prefijo consultado.
+ *
+ * @param rutaPalabras Diccionario inicial.
+ * @param rutaTexto Texto que aplica el escritor.
+ * @param segundos Duración de cada medición.
+ */
+inline void compararConcurrencia(const string& rutaPalabras, const string& rutaTexto, double segundos = 1.0) {
+    MappedFile diccionario(rutaPalabras);
+    vector<string_view> palabras = separarPalabras(diccionario);
+    MappedFile texto(rutaTexto);
+    vector<string_view> tokens = separarPalabras(texto);
+
+    vector<string_view> muestra;
+    size_t paso = max<size_t>(1, palabras.size() / 8192);
+    for (size_t k = 0; k < palabras.size(); k += paso) muestra.push_back(palabras[k]);
+
+    cout << "Nucleos disponibles: " << thread::hardware_concurrency() << "\n";
+    for (unsigned lectores : {1u, 2u, 4u, 8u}) {
+        for (bool con_escritor : {false, true}) {
+            Trie trie(RECENT);
+            trie.build_sorted(palabras);
+            trie.set_concurrent(true);
+
+            atomic<bool> fin(false);
+            atomic<uint64_t> consultas(0), errores(0);
+            uint64_t escrituras = 0;
+
+            vector<thread> hilos;
+            for (unsigned h = 0; h < lectores; ++h) {
+                hilos.emplace_back([&, h]() {
+                    EpochReader lector(trie.get_epochs());
+                    uint64_t n = 0, malos = 0;
+                    size_t i = h * 977 % muestra.size();
+                    while (!fin.load(memory_order_relaxed)) {
+                        string_view w = muestra[i];
+                        i = (i + 1) % muestra.size();
+
+                        EpochGuard guard(lector);
+                        TrieNode* node = trie.get_root();
+                        for (size_t d = 0; d < w.size() && node; ++d) {
+                            node = trie.descend(node, w[d]);
+                            string_view s = trie.get_word(trie.autocomplete(node));
+                            if (!s.empty() && (s.size() <= d + 1 || s.substr(0, d + 1) != w.substr(0, d + 1))) malos++;
+                            n++;
+                        }
+                    }
+                    consultas += n;
+                    errores += malos;
+                });
+            }
+
+            auto start = chrono::high_resolution_clock::now();
+            auto transcurrido = [&]() {
+                return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+            };
+            if (con_escritor) {
+                string nueva;
+                for (uint64_t vuelta = 0; transcurrido() < segundos; ++vuelta) {
+                    for (size_t i = 0; i < tokens.size() && (i % 1024 || transcurrido() < segundos); ++i) {
+                        if (vuelta == 0) {
+                            trie.update_priority(trie.insert(tokens[i]));
+                        } else {
+                            nueva.assign(tokens[i]);
+                            nueva += (char)('a' + vuelta % 26);
+                            trie.update_priority(trie.insert(nueva));
+                        }
+                        escrituras++;
+                    }
+                }
+            } else {
+                this_thread::sleep_for(chrono::duration<double>(segundos));
+            }
+            fin = true;
+            for (thread& t : hilos) t.join();
+            double s = transcurrido();
+
+            cout << lectores << " lectores" << (con_escritor ? " + escritor: " : ":            ")
+                 << consultas / s / 1e6 << " M consultas/s";
+            if (con_escritor) cout << ", " << escrituras / s / 1e6 << " M escrituras/s";
+            cout << ", " << errores << " sugerencias invalidas\n";
+        }
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara reconstruir un Trie entrenado con cargarlo desde un snapshot.
+ *
+ * Entrena como la GUI (diccionario + `update_priority` sobre el texto), lo
+ * guarda con `Trie::save`, lo carga con `Trie::load` y verifica que las
+ * sugerencias de una muestra de prefijos coincidan.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento.
+ * @param rutaSnapshot Archivo donde guardar el snapshot.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararSnapshot(const string& rutaPalabras, const string& rutaTexto,
+                             const string& rutaSnapshot, int variante) {
+    auto segundos = [](chrono::high_resolution_clock::time_point desde) {
+        return chrono::duration<double>(chrono::high_resolution_clock::now() - desde).count();
+    };
+
+    auto t1 = chrono::high_resolution_clock::now();
+    Trie original(variante);
+    cargarSilencioso(original, rutaPalabras);
+    entrenarSilencioso(original, rutaTexto);
+    double reconstruir = segundos(t1);
+
+    auto t2 = chrono::high_resolution_clock::now();
+    original.save(rutaSnapshot);
+    double guardar = segundos(t2);
+
+    auto t3 = chrono::high_resolution_clock::now();
+    Trie cargado(variante);
+    cargado.load(rutaSnapshot);
+    double cargar = segundos(t3);
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 4096);
+    uint64_t consultas = 0, iguales = 0;
+    for (const string& w : muestra) {
+        TrieNode* a = original.get_root();
+        TrieNode* b = cargado.get_root();
+        for (char c : w) {
+            a = original.descend(a, c);
+            b = cargado.descend(b, c);
+            consultas++;
+            if (original.get_word(original.autocomplete(a)) == cargado.get_word(cargado.autocomplete(b))) iguales++;
+        }
+    }
+
+    MappedFile archivo(rutaSnapshot);
+    cout << "Reconstruir (diccionario + texto): " << reconstruir << " s\n";
+    cout << "Guardar snapshot: " << guardar << " s, " << archivo.size() << " bytes\n";
+    cout << "Cargar snapshot:  " << cargar << " s (" << archivo.size() / 1e6 / cargar << " MB/s), "
+         << iguales << "/" << consultas << " sugerencias iguales\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide el log de prioridades: costo del fsync por grupos y tiempo de
+ * recuperación (snapshot + log) frente a reconstruir desde el corpus.
+ *
+ * Se carga el diccionario y se guarda como generación base; el entrenamiento
+ * sobre el texto pasa por el log. Luego se recupera repitiendo el log, se
+ * compacta en segundo plano y se recupera de nuevo (ya sin log que repetir).
+ * En cada caso se verifica que las sugerencias coincidan con un Trie
+ * entrenado directamente.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento.
+ * @param rutaBase Ruta base de los archivos del log (se borran los previos).
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararRecuperacion(const string& rutaPalabras, const string& rutaTexto,
+                                 const string& rutaBase, int variante) {
+    auto segundos = [](chrono::high_resolution_clock::time_point desde) {
+        return chrono::duration<double>(chrono::high_resolution_clock::now() - desde).count();
+    };
+
+    DurableTrie::discard(rutaBase);   // estado de una ejecución anterior
+
+    // fsync por registro vs por grupos
+    {
+        string ruta = rutaBase + ".prueba.wal";
+        remove(ruta.c_str());
+        vector<string> muestra = muestraPalabras(rutaTexto, 4096);
+        const uint64_t individuales = 256, agrupados = 1 << 18;
+
+        double por_registro, por_grupo;
+        uint64_t fsyncs;
+        {
+            PriorityLog log(ruta);
+            auto t = chrono::high_resolution_clock::now();
+            for (uint64_t i = 0; i < individuales; ++i) {
+                log.append(LOG_USE, muestra[i % muestra.size()]);
+                log.sync();
+            }
+            por_registro = segundos(t);
+
+            uint64_t antes = log.fsyncs();
+            t = chrono::high_resolution_clock::now();
+            for (uint64_t i = 0; i < agrupados; ++i) log.append(LOG_USE, muestra[i % muestra.size()]);
+            log.sync();
+            por_grupo = segundos(t);
+            fsyncs = log.fsyncs() - antes;
+        }
+        remove(ruta.c_str());
+
+        cout << "fsync por registro: " << individuales / por_registro << " registros/s\n";
+        cout << "fsync por grupos:   " << agrupados / por_grupo << " registros/s (" << agrupados << " registros, "
+             << fsyncs << " fsync)\n";
+    }
+
+    auto t1 = chrono::high_resolution_clock::now();
+    Trie referencia(variante);
+    cargarSilencioso(referencia, rutaPalabras);
+    entrenarSilencioso(referencia, rutaTexto);
+    double reconstruir = segundos(t1);
+
+    double entrenar;
+    uint64_t registros;
+    {
+        DurableTrie durable(rutaBase, variante, ADAPTIVE_LAYOUT, 0);
+        cargarSilencioso(durable.trie(), rutaPalabras);
+        durable.checkpoint();
+
+        auto t = chrono::high_resolution_clock::now();
+        entrenarSilencioso(durable, rutaTexto);
+        durable.sync();
+        entrenar = segundos(t);
+        registros = durable.active_log().appended_records();
+    }
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 4096);
+    auto comparar = [&](DurableTrie& d) {
+        uint64_t consultas = 0, iguales = 0;
+        for (const string& w : muestra) {
+            TrieNode* a = referencia.get_root();
+            TrieNode* b = d.get_root();
+            for (char c : w) {
+                a = referencia.descend(a, c);
+                b = d.descend(b, c);
+                consultas++;
+                if (referencia.get_word(referencia.autocomplete(a)) == d.get_word(d.autocomplete(b))) iguales++;
+            }
+        }
+        cout << iguales << "/" << consultas << " sugerencias iguales\n";
+    };
+
+    double recuperar, compactar, recuperar_compactado;
+    uint64_t repetidos;
+    {
+        auto t = chrono::high_resolution_clock::now();
+        DurableTrie durable(rutaBase, variante);
+        recuperar = segundos(t);
+        repetidos = durable.replayed_records();
+        cout << "Reconstruir (diccionario + texto): " << reconstruir << " s\n";
+        cout << "Entrenar registrando en el log:    " << entrenar << " s (" << registros << " registros)\n";
+        cout << "Recuperar (snapshot + log):        " << recuperar << " s (" << repetidos << " registros repetidos), ";
+        comparar(durable);
+
+        t = chrono::high_resolution_clock::now();
+        durable.compact();
+        durable.wait_compaction();
+        compactar = segundos(t);
+    }
+    {
+        auto t = chrono::high_resolution_clock::now();
+        DurableTrie durable(rutaBase, variante);
+        recuperar_compactado = segundos(t);
+        cout << "Compactar en segundo plano:        " << compactar << " s\n";
+        cout << "Recuperar tras compactar:          " << recuperar_compactado << " s ("
+             << durable.replayed_records() << " registros repetidos), ";
+        comparar(durable);
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara el Trie mutable con su versión congelada en LOUDS.
+ *
+ * Entrena como la GUI, congela el resultado con `LoudsTrie` e informa la
+ * memoria de cada uno (en bits por nodo para el LOUDS, separando forma del
+ * árbol, mejores terminales y palabras). Luego escribe las palabras de una
+ * muestra carácter a carácter en ambos, consultando la sugerencia en cada
+ * prefijo, y compara tiempos y respuestas.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararLouds(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    LoudsTrie louds(trie);
+    double congelar = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+
+    double n = louds.get_size();
+    cout << "Trie:  " << trie.get_size() << " nodos, " << trie.memory_bytes() << " bytes ("
+         << trie.memory_bytes() * 8.0 / n << " bits/nodo)\n";
+    cout << "LOUDS: " << louds.get_size() << " nodos, " << louds.memory_bytes() << " bytes, congelado en "
+         << congelar << " s\n";
+    cout << "  forma (LOUDS + etiquetas + terminales): " << louds.structure_bytes() * 8.0 / n << " bits/nodo\n";
+    cout << "  mejores terminales: " << louds.best_bytes() * 8.0 / n << " bits/nodo\n";
+    cout << "  palabras: " << louds.words_bytes() << " bytes (" << louds.get_words() << " palabras)\n";
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+    uint64_t consultas = 0, iguales = 0, suma_trie = 0, suma_louds = 0;
+
+    auto t1 = chrono::high_resolution_clock::now();
+    for (const string& w : muestra) {
+        TrieNode* v = trie.get_root();
+        for (char c : w) {
+            v = trie.descend(v, c);
+            if (!v) break;
+            TrieNode* mejor = trie.autocomplete(v);
+            suma_trie += mejor ? trie.get_word(mejor).size() : 0;
+        }
+    }
+    double t_trie = chrono::duration<double>(chrono::high_resolution_clock::now() - t1).count();
+
+    auto t2 = chrono::high_resolution_clock::now();
+    for (const string& w : muestra) {
+        uint32_t v = louds.get_root();
+        for (char c : w) {
+            v = louds.descend(v, c);
+            if (!v) break;
+            suma_louds += louds.get_word(louds.autocomplete(v)).size();
+        }
+    }
+    double t_louds = chrono::duration<double>(chrono::high_resolution_clock::now() - t2).count();
+
+    for (const string& w : muestra) {
+        TrieNode* a = trie.get_root();
+        uint32_t b = louds.get_root();
+        for (char c : w) {
+            a = trie.descend(a, c);
+            b = louds.descend(b, c);
+            consultas++;
+            if ((a == nullptr) == (b == 0) &&
+                trie.get_word(trie.autocomplete(a)) == louds.get_word(louds.autocomplete(b))) {
+                iguales++;
+            }
+            if (!a) break;
+        }
+    }
+
+    cout << "Trie:  " << t_trie << " s escribiendo la muestra\n";
+    cout << "LOUDS: " << t_louds << " s escribiendo la muestra, " << iguales << "/" << consultas
+         << " sugerencias iguales" << (suma_trie == suma_louds ? "" : " (sumas de control distintas)") << "\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara el Trie con el autómata mínimo (DAWG) con prioridades por id.
+ *
+ * Entrena el Trie como la GUI y construye el DAWG con sus palabras y
+ * prioridades. Informa estados, aristas y memoria de cada parte, y luego
+ * escribe una muestra carácter a carácter consultando la sugerencia en cada
+ * prefijo y usando la palabra completa (`update_priority`) en ambos. Se
+ * comparan las prioridades sugeridas, ya que los empates pueden resolverse
+ * distinto.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararDawg(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    Dawg dawg(trie);
+    double construir = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+
+    cout << "Trie: " << trie.get_size() << " nodos, " << trie.memory_bytes() << " bytes\n";
+    cout << "DAWG: " << dawg.get_size() << " estados, " << dawg.get_edges() << " aristas, "
+         << dawg.get_words() << " palabras, " << dawg.memory_bytes() << " bytes, construido en " << construir << " s\n";
+    cout << "  automata: " << dawg.automaton_bytes() << " bytes\n";
+    cout << "  prioridades y arbol de segmentos por id: " << dawg.side_bytes() << " bytes\n";
+    cout << "  palabras: " << dawg.words_bytes() << " bytes\n";
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+    uint64_t consultas = 0, iguales = 0, suma_trie = 0, suma_dawg = 0;
+
+    auto t1 = chrono::high_resolution_clock::now();
+    for (const string& w : muestra) {
+        TrieNode* v = trie.get_root();
+        for (char c : w) {
+            v = trie.descend(v, c);
+            if (!v) break;
+            TrieNode* mejor = trie.autocomplete(v);
+            suma_trie += mejor ? mejor->priority : 0;
+        }
+        if (v && trie.is_terminal(v)) trie.update_priority(v);
+    }
+    double t_trie = chrono::duration<double>(chrono::high_resolution_clock::now() - t1).count();
+
+    auto t2 = chrono::high_resolution_clock::now();
+    for (const string& w : muestra) {
+        DawgPos p = dawg.get_root();
+        for (char c : w) {
+            p = dawg.descend(p, c);
+            if (!p) break;
+            uint32_t mejor = dawg.autocomplete(p);
+            suma_dawg += mejor ? dawg.get_priority(mejor) : 0;
+        }
+        dawg.update_priority(dawg.word_id(p));
+    }
+    double t_dawg = chrono::duration<double>(chrono::high_resolution_clock::now() - t2).count();
+
+    for (const string& w : muestra) {
+        TrieNode* a = trie.get_root();
+        DawgPos b = dawg.get_root();
+        for (char c : w) {
+            a = trie.descend(a, c);
+            b = dawg.descend(b, c);
+            consultas++;
+            TrieNode* x = trie.autocomplete(a);
+            uint32_t y = dawg.autocomplete(b);
+            if ((a == nullptr) == !b && (x ? x->priority : 0) == (y ? dawg.get_priority(y) : 0)) iguales++;
+            if (!a) break;
+        }
+    }
+
+    cout << "Trie: " << t_trie << " s escribiendo la muestra\n";
+    cout << "DAWG: " << t_dawg << " s escribiendo la muestra, " << iguales << "/" << consultas
+         << " sugerencias con la misma prioridad" << (suma_trie == suma_dawg ? "" : " (sumas de control distintas)")
+         << "\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara consultar por tecla descendiendo desde la raíz contra usar
+ * un `TrieCursor`.
+ *
+ * Simula escribir una muestra del texto: cada palabra se escribe completa,
+ * se borran sus dos últimos caracteres y se vuelven a escribir, pidiendo la
+ * sugerencia en cada tecla. Sin cursor cada tecla vuelve a bajar el prefijo
+ * completo desde la raíz (como hacía la GUI); con cursor cuesta un `push` o
+ * `pop` y un `best`.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento y de la muestra.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararCursor(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+
+    // teclas de cada palabra: caracteres, dos retrocesos (0) y los dos últimos de nuevo
+    vector<char> teclas;
+    vector<size_t> inicios;
+    for (const string& w : muestra) {
+        inicios.push_back(teclas.size());
+        teclas.insert(teclas.end(), w.begin(), w.end());
+        size_t borrar = min<size_t>(2, w.size());
+        teclas.insert(teclas.end(), borrar, 0);
+        teclas.insert(teclas.end(), w.end() - borrar, w.end());
+    }
+    inicios.push_back(teclas.size());
+
+    vector<TrieNode*> desde_raiz, con_cursor;
+    desde_raiz.reserve(teclas.size());
+    con_cursor.reserve(teclas.size());
+
+    auto t1 = chrono::high_resolution_clock::now();
+    string prefijo;
+    for (size_t i = 0; i + 1 < inicios.size(); ++i) {
+        prefijo.clear();
+        for (size_t j = inicios[i]; j < inicios[i + 1]; ++j) {
+            if (teclas[j]) prefijo.push_back(teclas[j]);
+            else prefijo.pop_back();
+
+            TrieNode* v = trie.get_root();
+            for (char c : prefijo) {
+                v = trie.descend(v, c);
+                if (!v) break;
+            }
+            desde_raiz.push_back(trie.autocomplete(v));
+        }
+    }
+    double t_raiz = chrono::duration<double>(chrono::high_resolution_clock::now() - t1).count();
+
+    auto t2 = chrono::high_resolution_clock::now();
+    TrieCursor cursor(trie);
+    for (size_t i = 0; i + 1 < inicios.size(); ++i) {
+        cursor.reset();
+        for (size_t j = inicios[i]; j < inicios[i + 1]; ++j) {
+            if (teclas[j]) cursor.push(teclas[j]);
+            else cursor.pop();
+            con_cursor.push_back(cursor.best());
+        }
+    }
+    double t_cursor = chrono::duration<double>(chrono::high_resolution_clock::now() - t2).count();
+
+    cout << "Teclas simuladas: " << teclas.size() << "\n";
+    cout << "Desde la raiz: " << t_raiz * 1e9 / teclas.size() << " ns/tecla\n";
+    cout << "TrieCursor:    " << t_cursor * 1e9 / teclas.size() << " ns/tecla, "
+         << (desde_raiz == con_cursor ? "mismas sugerencias" : "SUGERENCIAS DISTINTAS") << "\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara buscar prefijos uno tras otro con `lookup_batch`.
+ *
+ * Dos cargas: todos los prefijos de una muestra de palabras, en orden
+ * aleatorio (consultas independientes de un servidor), y las palabras del
+ * texto en su orden (como repetir el texto con `recorrer`). Para cada tamaño
+ * de grupo se informa el throughput y si los resultados coinciden con la
+ * búsqueda secuencial.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento y de las consultas.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararLotes(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+    vector<string_view> prefijos;
+    for (const string& w : muestra) {
+        for (size_t i = 1; i <= w.size(); ++i) prefijos.push_back(string_view(w).substr(0, i));
+    }
+    // orden aleatorio reproducible (LCG), para que consultas vecinas no compartan camino
+    uint64_t estado = 12345;
+    for (size_t i = prefijos.size(); i > 1; --i) {
+        estado = estado * 6364136223846793005ULL + 1442695040888963407ULL;
+        swap(prefijos[i - 1], prefijos[(estado >> 33) % i]);
+    }
+
+    MappedFile texto(rutaTexto);
+    vector<string_view> palabras = separarPalabras(texto);
+    if (palabras.size() > prefijos.size()) palabras.resize(prefijos.size());
+
+    auto medir = [&](const char* nombre, const vector<string_view>& consultas) {
+        vector<TrieNode*> nodos(consultas.size()), mejores(consultas.size());
+        auto t0 = chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < consultas.size(); ++i) {
+            TrieNode* v = trie.get_root();
+            for (char c : consultas[i]) {
+                v = trie.descend(v, c);
+                if (!v) break;
+            }
+            nodos[i] = v;
+            mejores[i] = trie.autocomplete(v);
+        }
+        double base = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+        cout << nombre << " (" << consultas.size() << " consultas)\n";
+        cout << "  secuencial: " << consultas.size() / base / 1e6 << " M consultas/s\n";
+
+        for (unsigned grupo : {1u, 4u, 8u, 16u, 32u}) {
+            vector<TrieNode*> n2, m2;
+            auto t = chrono::high_resolution_clock::now();
+            trie.lookup_batch(consultas, n2, m2, grupo);
+            double s = chrono::duration<double>(chrono::high_resolution_clock::now() - t).count();
+            cout << "  lote, grupo " << grupo << ": " << consultas.size() / s / 1e6 << " M consultas/s ("
+                 << base / s << "x)" << (n2 == nodos && m2 == mejores ? "" : ", RESULTADOS DISTINTOS") << "\n";
+        }
+    };
+
+    medir("Prefijos en orden aleatorio", prefijos);
+    medir("Palabras del texto en orden", palabras);
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide la tabla de prefijos cortos de `Trie` para L = 2..5.
+ *
+ * Busca todos los prefijos de una muestra de palabras, en orden aleatorio,
+ * con `find_prefix` + `autocomplete`. L = 0 es el descenso normal desde la
+ * raíz. Informa la latencia, la ganancia y la memoria de la tabla, y si los
+ * resultados coinciden con los de L = 0.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento y de las consultas.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararSaltos(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+    vector<string_view> prefijos;
+    for (const string& w : muestra) {
+        for (size_t i = 1; i <= w.size(); ++i) prefijos.push_back(string_view(w).substr(0, i));
+    }
+    uint64_t estado = 12345;
+    for (size_t i = prefijos.size(); i > 1; --i) {
+        estado = estado * 6364136223846793005ULL + 1442695040888963407ULL;
+        swap(prefijos[i - 1], prefijos[(estado >> 33) % i]);
+    }
+
+    const int repeticiones = 5;
+    vector<TrieNode*> base;
+    double ns_base = 0;
+    cout << "Consultas: " << prefijos.size() << " prefijos x " << repeticiones << "\n";
+    for (uint32_t largo : {0u, 2u, 3u, 4u, 5u}) {
+        trie.enable_jump_table(largo);
+        vector<TrieNode*> resultados(prefijos.size());
+        auto t0 = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeticiones; ++r) {
+            for (size_t i = 0; i < prefijos.size(); ++i) {
+                resultados[i] = trie.autocomplete(trie.find_prefix(prefijos[i]));
+            }
+        }
+        double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - t0).count() /
+                    (double)(prefijos.size() * repeticiones);
+        if (largo == 0) {
+            base = resultados;
+            ns_base = ns;
+            cout << "  sin tabla: " << ns << " ns/consulta\n";
+            continue;
+        }
+        cout << "  L = " << largo << ": " << ns << " ns/consulta (" << ns_base / ns << "x), "
+             << trie.jump_bytes() / 1024.0 << " KB de tabla (" << trie.jump_bytes() * 100.0 / trie.memory_bytes()
+             << "% del Trie)" << (resultados == base ? "" : ", RESULTADOS DISTINTOS") << "\n";
+    }
+    trie.enable_jump_table(0);
+    cout << " === === \n";
+}
+
+/**
+ * @brief Contador de fallos de caché del hilo actual (L1 de datos y último nivel).
+ *
+ * Usa `perf_event_open` en Linux. Si los contadores de hardware no están
+ * disponibles (otro sistema, máquina virtual o permisos) `disponible()` es
+ * falso y las lecturas valen 0.
+ */
+class ContadorFallos {
+public:
+    ContadorFallos() {
+#ifdef __linux__
+        fd_l1 = abrir(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fd_llc = abrir(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~ContadorFallos() {
+#ifdef __linux__
+        if (fd_l1 >= 0) close(fd_l1);
+        if (fd_llc >= 0) close(fd_llc);
+#endif
+    }
+
+    ContadorFallos(const ContadorFallos&) = delete;
+    ContadorFallos& operator=(const ContadorFallos&) = delete;
+
+    /** @brief True si al menos uno de los contadores funciona. */
+    bool disponible() const { return fd_l1 >= 0 || fd_llc >= 0; }
+
+    /** @brief Fallos de L1 de datos (lecturas) acumulados. */
+    uint64_t l1() const { return leer(fd_l1); }
+
+    /** @brief Fallos de caché de último nivel acumulados. */
+    uint64_t llc() const { return leer(fd_llc); }
+
+private:
+    int fd_l1 = -1;
+    int fd_llc = -1;
+
+#ifdef __linux__
+    static int abrir(uint32_t tipo, uint64_t config) {
+        perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.type = tipo;
+        a.size = sizeof(a);
+        a.config = config;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        return (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+    }
+#endif
+
+    static uint64_t leer(int fd) {
+        uint64_t v = 0;
+#ifdef __linux__
+        if (fd >= 0 && read(fd, &v, sizeof(v)) != sizeof(v)) v = 0;
+#else
+        (void)fd;
+#endif
+        return v;
+    }
+};
+
+/**
+ * @brief Mide `Trie::compact` en un Trie cargado en el orden del archivo y en
+ * uno cargado en orden aleatorio.
+ *
+ * Para cada uno se entrena con el texto y se consultan todos los prefijos de
+ * una muestra (descenso + `autocomplete` + palabra sugerida), antes y después
+ * de compactar. Se informa la latencia, los fallos de caché por consulta (si
+ * hay contadores de hardware) y si las sugerencias coinciden.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto de entrenamiento y de las consultas.
+ * @param variante FREQUENCY o RECENT.
+ */
+inline void compararCompactacion(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    vector<string> muestra = muestraPalabras(rutaTexto, 1 << 16);
+    vector<string_view> prefijos;
+    for (const string& w : muestra) {
+        for (size_t i = 1; i <= w.size(); ++i) prefijos.push_back(string_view(w).substr(0, i));
+    }
+    uint64_t estado = 12345;
+    auto azar = [&]() {
+        estado = estado * 6364136223846793005ULL + 1442695040888963407ULL;
+        return estado >> 33;
+    };
+    for (size_t i = prefijos.size(); i > 1; --i) swap(prefijos[i - 1], prefijos[azar() % i]);
+
+    MappedFile diccionario(rutaPalabras);
+    vector<string_view> palabras = separarPalabras(diccionario);
+
+    ContadorFallos contador;
+    const int repeticiones = 5;
+    auto medir = [&](Trie& trie, vector<string_view>& sugerencias) {
+        uint64_t l1 = contador.l1(), llc = contador.llc();
+        auto t0 = chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeticiones; ++r) {
+            for (size_t i = 0; i < prefijos.size(); ++i) {
+                TrieNode* v = trie.get_root();
+                for (char c : prefijos[i]) {
+                    v = trie.descend(v, c);
+                    if (!v) break;
+                }
+                sugerencias[i] = trie.get_word(trie.autocomplete(v));
+            }
+        }
+        double consultas = (double)prefijos.size() * repeticiones;
+        double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - t0).count() / consultas;
+        cout << ns << " ns/consulta";
+        if (contador.disponible()) {
+            cout << ", fallos por consulta: L1 " << (contador.l1() - l1) / consultas
+                 << ", LLC " << (contador.llc() - llc) / consultas;
+        }
+        cout << "\n";
+        return ns;
+    };
+
+    for (bool aleatorio : {false, true}) {
+        if (aleatorio) {
+            for (size_t i = palabras.size(); i > 1; --i) swap(palabras[i - 1], palabras[azar() % i]);
+        }
+        Trie trie(variante);
+        for (string_view w : palabras) trie.insert(w);
+        entrenarSilencioso(trie, rutaTexto);
+
+        cout << (aleatorio ? "Diccionario en orden aleatorio" : "Diccionario en orden del archivo")
+             << " (" << prefijos.size() << " prefijos x " << repeticiones << ")\n";
+        vector<string_view> antes(prefijos.size()), despues(prefijos.size());
+        cout << "  antes de compactar:   ";
+        double t_antes = medir(trie, antes);
+
+        auto t0 = chrono::high_resolution_clock::now();
+        trie.compact();
+        double s = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+        cout << "  despues de compactar: ";
+        double t_despues = medir(trie, despues);
+        cout << "  mejora: " << t_antes / t_despues << "x, compactar tomo " << s << " s"
+             << (antes == despues ? "" : ", SUGERENCIAS DISTINTAS") << "\n";
+    }
+    if (!contador.disponible()) cout << "(contadores de fallos de cache no disponibles en este sistema)\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara `update_priority` eligiendo la política en cada llamada con
+ * la versión con la política fijada en compilación.
+ *
+ * Repite en dos Trie iguales los usos de las palabras del texto que están en
+ * el diccionario (como `recorrer`, sin las consultas) y verifica que ambos
+ * terminen con las mismas prioridades.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ */
+inline void compararPoliticas(const string& rutaPalabras, const string& rutaTexto) {
+    MappedFile texto(rutaTexto);
+    vector<string_view> usos = separarPalabras(texto);
+
+    for (int variante : {FREQUENCY, RECENT}) {
+        Trie dinamico(variante), fijo(variante);
+        cargarSilencioso(dinamico, rutaPalabras);
+        cargarSilencioso(fijo, rutaPalabras);
+
+        vector<TrieNode*> a, b;
+        for (string_view w : usos) {
+            TrieNode* v = dinamico.find_prefix(w);
+            if (!dinamico.is_terminal(v)) continue;
+            a.push_back(v);
+            b.push_back(fijo.find_prefix(w));
+        }
+
+        auto t0 = chrono::high_resolution_clock::now();
+        for (TrieNode* v : a) dinamico.update_priority(v);
+        double s_dinamico = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+
+        t0 = chrono::high_resolution_clock::now();
+        withPolicy(variante, [&](auto p) {
+            for (TrieNode* v : b) fijo.update_priority<decltype(p)>(v);
+        });
+        double s_fijo = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+
+        bool iguales = true;
+        for (size_t i = 0; i < a.size() && iguales; ++i) {
+            iguales = a[i]->priority == b[i]->priority &&
+                      dinamico.get_word(dinamico.autocomplete(a[i])) == fijo.get_word(fijo.autocomplete(b[i]));
+        }
+
+        cout << (variante == FREQUENCY ? "Frecuencia" : "Reciente") << " (" << a.size() << " usos)\n";
+        cout << "  politica en cada llamada: " << a.size() / s_dinamico / 1e6 << " M usos/s\n";
+        cout << "  politica en compilacion:  " << b.size() / s_fijo / 1e6 << " M usos/s ("
+             << s_dinamico / s_fijo << "x)" << (iguales ? "" : ", PRIORIDADES DISTINTAS") << "\n";
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara la propagación normal de RECENT con el modo perezoso
+ * (`Trie::set_lazy_recent`).
+ *
+ * Simula `recorrer` sin imprimir: por cada palabra del texto consulta la
+ * sugerencia de cada prefijo y después registra el uso. Informa el tiempo de
+ * las actualizaciones, los ancestros escritos por uso y los caracteres
+ * escritos, que deben coincidir en ambos modos.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ */
+inline void compararRecientePerezoso(const string& rutaPalabras, const string& rutaTexto) {
+    MappedFile texto(rutaTexto);
+    vector<string_view> usos = separarPalabras(texto);
+
+    uint64_t escritos_base = 0;
+    double total_base = 0, actualizar_base = 0;
+    for (bool perezoso : {false, true}) {
+        Trie trie(RECENT);
+        cargarSilencioso(trie, rutaPalabras);
+        trie.set_lazy_recent(perezoso);
+
+        uint64_t escritos = 0, usados = 0;
+        chrono::duration<double> actualizar{0};
+        auto t0 = chrono::high_resolution_clock::now();
+        for (string_view w : usos) {
+            TrieNode* node = trie.get_root();
+            size_t i = 0;
+            while (i < w.size()) {
+                node = trie.descend(node, w[i++]);
+                if (!node || trie.get_word(trie.autocomplete(node)) == w) break;
+            }
+            escritos += node ? i : w.size();
+
+            TrieNode* usado = trie.find_prefix(w);
+            if (trie.is_terminal(usado)) {
+                auto t1 = chrono::high_resolution_clock::now();
+                trie.update_priority<RecentPolicy>(usado);
+                actualizar += chrono::high_resolution_clock::now() - t1;
+                usados++;
+            }
+        }
+        double total = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+
+        if (!perezoso) {
+            escritos_base = escritos;
+            total_base = total;
+            actualizar_base = actualizar.count();
+        }
+        cout << (perezoso ? "Perezoso:           " : "Propagacion normal: ") << total << " s en total ("
+             << total_base / total << "x), actualizaciones " << actualizar.count() * 1e9 / usados << " ns/uso ("
+             << actualizar_base / actualizar.count() << "x), " << (double)trie.get_propagation_steps() / usados
+             << " ancestros escritos por uso" << (escritos == escritos_base ? "" : ", SUGERENCIAS DISTINTAS") << "\n";
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide la baja de prioridades (`Trie::set_priority`) y los borrados
+ * (`Trie::remove`) bajo altas y bajas repetidas.
+ *
+ * 1. Baja a la mitad la prioridad de cada palabra usada del diccionario y
+ *    compara el costo de cada reparación con recalcular todo el Trie.
+ * 2. Repite rondas que borran y vuelven a insertar un cuarto del
+ *    diccionario: los nodos y la memoria no deben crecer entre rondas.
+ *
+ * Al final compara las sugerencias de los prefijos de largo 1 a 3 con un Trie
+ * construido desde cero con las mismas palabras y prioridades.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ * @param variante Variante del Trie.
+ */
+inline void compararEliminacion(const string& rutaPalabras, const string& rutaTexto, int variante) {
+    auto segundos = [](chrono::high_resolution_clock::time_point desde) {
+        return chrono::duration<double>(chrono::high_resolution_clock::now() - desde).count();
+    };
+
+    MappedFile diccionario(rutaPalabras);
+    vector<string_view> palabras = separarPalabras(diccionario);
+    Trie trie(variante);
+    for (string_view w : palabras) trie.insert(w);
+    // sólo se usan palabras del diccionario, para poder reconstruirlo al final
+    MappedFile texto(rutaTexto);
+    for (string_view w : separarPalabras(texto)) {
+        TrieNode* v = trie.find_prefix(w);
+        if (trie.is_terminal(v)) trie.update_priority(v);
+    }
+
+    vector<string_view> usadas;
+    for (string_view w : palabras) {
+        TrieNode* v = trie.find_prefix(w);
+        if (trie.is_terminal(v) && v->priority > 0) usadas.push_back(w);
+    }
+    uint64_t pasos = trie.get_propagation_steps();
+    auto t0 = chrono::high_resolution_clock::now();
+    for (string_view w : usadas) trie.set_priority(w, trie.find_prefix(w)->priority / 2);
+    double s_bajar = segundos(t0);
+    double ancestros = (double)(trie.get_propagation_steps() - pasos) / usadas.size();
+
+    auto t1 = chrono::high_resolution_clock::now();
+    trie.decay(1.0);  // no cambia prioridades: sólo recalcula todos los mejores terminales
+    double s_todo = segundos(t1);
+    cout << "Bajar prioridad (" << usadas.size() << " palabras): " << s_bajar * 1e9 / usadas.size() << " ns y "
+         << ancestros << " ancestros por palabra; recalcular todo el Trie: " << s_todo * 1e3 << " ms\n";
+
+    uint64_t estado = 12345;
+    auto azar = [&]() {
+        estado = estado * 6364136223846793005ULL + 1442695040888963407ULL;
+        return estado >> 33;
+    };
+    cout << "Altas y bajas (un cuarto del diccionario por ronda), inicio: " << trie.get_size() << " nodos, "
+         << trie.memory_bytes() << " bytes\n";
+    for (int ronda = 1; ronda <= 5; ++ronda) {
+        vector<string_view> elegidas;
+        for (string_view w : palabras) {
+            if (azar() % 4 == 0) elegidas.push_back(w);
+        }
+        auto t2 = chrono::high_resolution_clock::now();
+        for (string_view w : elegidas) trie.remove(w);
+        double s_borrar = segundos(t2);
+        int nodos_sin = trie.get_size();
+
+        auto t3 = chrono::high_resolution_clock::now();
+        for (string_view w : elegidas) trie.insert(w);
+        double s_insertar = segundos(t3);
+        cout << "  ronda " << ronda << ": borrar " << s_borrar * 1e9 / elegidas.size() << " ns/palabra (quedan "
+             << nodos_sin << " nodos), reinsertar " << s_insertar * 1e9 / elegidas.size() << " ns/palabra, "
+             << trie.get_size() << " nodos, " << trie.memory_bytes() << " bytes\n";
+    }
+
+    vector<string_view> vivas;
+    vector<uint32_t> prioridades;
+    for (string_view w : palabras) {
+        TrieNode* v = trie.find_prefix(w);
+        if (!trie.is_terminal(v)) continue;
+        vivas.push_back(w);
+        prioridades.push_back(v->priority);
+    }
+    Trie referencia(variante);
+    referencia.build_sorted(vivas, prioridades);
+
+    uint64_t consultas = 0, iguales = 0;
+    for (string_view w : vivas) {
+        for (size_t l = 1; l <= 3 && l <= w.size(); ++l) {
+            TrieNode* a = trie.autocomplete(trie.find_prefix(w.substr(0, l)));
+            TrieNode* b = referencia.autocomplete(referencia.find_prefix(w.substr(0, l)));
+            consultas++;
+            if ((a ? a->priority : 0) == (b ? b->priority : 0)) iguales++;
+        }
+    }
+    cout << "Sugerencias iguales a las de un Trie reconstruido: " << iguales << "/" << consultas << "\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide `Trie::fuzzy_autocomplete` con prefijos mal escritos.
+ *
+ * Toma prefijos (largo 3 a 8) de las palabras del texto y les aplica un
+ * error al azar (cambio, inserción, borrado o transposición). Para 1 y 2
+ * ediciones compara la latencia de las `k` mejores sugerencias con la de
+ * enumerar todas las palabras que calzan (la misma DP sin la poda por
+ * prioridad) y verifica que las prioridades coincidan.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ * @param variante Variante del Trie.
+ * @param k Cantidad de sugerencias.
+ */
+inline void compararDifuso(const string& rutaPalabras, const string& rutaTexto, int variante, uint32_t k) {
+    Trie trie(variante);
+    cargarSilencioso(trie, rutaPalabras);
+    entrenarSilencioso(trie, rutaTexto);
+
+    MappedFile texto(rutaTexto);
+    vector<string_view> usos = separarPalabras(texto);
+    uint64_t estado = 12345;
+    auto azar = [&]() {
+        estado = estado * 6364136223846793005ULL + 1442695040888963407ULL;
+        return estado >> 33;
+    };
+    vector<string> consultas;
+    size_t no_encontrados = 0;
+    for (size_t i = 0; i < usos.size() && consultas.size() < 2000; i += 1 + azar() % 64) {
+        if (usos[i].size() < 3) continue;
+        string p(usos[i].substr(0, min<size_t>(usos[i].size(), 3 + azar() % 6)));
+        size_t pos = azar() % p.size();
+        switch (azar() % 4) {
+            case 0: p[pos] = (char)('a' + azar() % 26); break;
+            case 1: p.insert(p.begin() + pos, (char)('a' + azar() % 26)); break;
+            case 2: p.erase(pos, 1); break;
+            default: if (pos + 1 < p.size()) swap(p[pos], p[pos + 1]); break;
+        }
+        if (!trie.find_prefix(p)) no_encontrados++;
+        consultas.push_back(p);
+    }
+    cout << consultas.size() << " prefijos con un error (" << no_encontrados
+         << " no existen en el Trie), " << trie.get_size() << " nodos\n";
+
+    for (uint32_t ediciones : {1u, 2u}) {
+        uint64_t con_sugerencia = 0, distintos = 0;
+        chrono::duration<double> t_podado{0}, t_todo{0};
+        for (const string& p : consultas) {
+            auto t0 = chrono::high_resolution_clock::now();
+            vector<TrieNode*> mejores = trie.fuzzy_autocomplete(p, ediciones, k);
+            auto t1 = chrono::high_resolution_clock::now();
+            vector<TrieNode*> todas = trie.fuzzy_autocomplete(p, ediciones, UINT32_MAX);
+            auto t2 = chrono::high_resolution_clock::now();
+            t_podado += t1 - t0;
+            t_todo += t2 - t1;
+
+            if (!mejores.empty()) con_sugerencia++;
+            // `todas` viene ordenada por prioridad: sus primeras k son la referencia
+            if (todas.size() > k) todas.resize(k);
+            bool iguales = mejores.size() == todas.size();
+            for (size_t i = 0; iguales && i < mejores.size(); ++i) iguales = mejores[i]->priority == todas[i]->priority;
+            if (!iguales) distintos++;
+        }
+        cout << ediciones << " edicion(es): top-" << k << " " << t_podado.count() * 1e6 / consultas.size()
+             << " us/consulta, todas las que calzan " << t_todo.count() * 1e6 / consultas.size()
+             << " us/consulta (" << t_todo.count() / t_podado.count() << "x), con sugerencia "
+             << con_sugerencia << "/" << consultas.size() << (distintos ? ", SUGERENCIAS DISTINTAS" : "") << "\n";
+    }
+    cout << " === === \n";
+}
+
+/**
+ * @brief Mide la predicción de la palabra siguiente con tablas de sucesores
+ * de distinta capacidad.
+ *
+ * Recorre el texto en orden: antes de ver cada palabra predice a partir de
+ * la anterior (top-1 y top-3) y después aprende el bigrama, como
+ * `recorrer`. Como referencia, un conteo exacto de todos los bigramas que
+ * predice con el sucesor más visto hasta el momento.
+ *
+ * Al final verifica que borrar y reinsertar palabras no deje predicciones
+ * ajenas ni haga crecer la memoria; si falla lanza `runtime_error` (y `main`
+ * termina con código 1).
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ */
+inline void compararSucesores(const string& rutaPalabras, const string& rutaTexto) {
+    MappedFile texto(rutaTexto);
+    vector<string_view> usos = separarPalabras(texto);
+
+    for (uint32_t capacidad : {1u, 2u, 4u, 8u, 16u}) {
+        Trie trie(FREQUENCY);
+        cargarSilencioso(trie, rutaPalabras);
+        trie.enable_successors(capacidad);
+
+        uint64_t predicciones = 0, aciertos1 = 0, aciertos3 = 0;
+        chrono::duration<double> consultar{0};
+        TrieNode* anterior = nullptr;
+        for (string_view w : usos) {
+            TrieNode* actual = trie.insert(w);
+            if (anterior) {
+                auto t0 = chrono::high_resolution_clock::now();
+                vector<TrieNode*> siguientes = trie.predict_next(anterior, 3);
+                consultar += chrono::high_resolution_clock::now() - t0;
+                predicciones++;
+                for (size_t i = 0; i < siguientes.size(); ++i) {
+                    if (siguientes[i] != actual) continue;
+                    if (i == 0) aciertos1++;
+                    aciertos3++;
+                }
+                trie.observe_successor(anterior, actual);
+            }
+            anterior = actual;
+        }
+        const SuccessorTable& sucesores = trie.successor_table();
+        cout << "Capacidad " << capacidad << ": aciertos top-1 " << (double)aciertos1 / predicciones * 100
+             << "%, top-3 " << (double)aciertos3 / predicciones * 100 << "%, consulta "
+             << consultar.count() * 1e9 / predicciones << " ns, " << (double)sucesores.bytes() / sucesores.tables()
+             << " bytes por palabra (" << sucesores.tables() << " palabras, " << sucesores.bytes() << " bytes)\n";
+    }
+
+    // referencia: conteo exacto de bigramas (por id de palabra) y el sucesor más visto de cada palabra
+    Trie trie(FREQUENCY);
+    cargarSilencioso(trie, rutaPalabras);
+    unordered_map<uint64_t, uint32_t> conteos;
+    unordered_map<const TrieNode*, pair<const TrieNode*, uint32_t>> mejor;
+    uint64_t predicciones = 0, aciertos = 0;
+    const TrieNode* anterior = nullptr;
+    for (string_view w : usos) {
+        const TrieNode* actual = trie.insert(w);
+        if (anterior) {
+            auto it = mejor.find(anterior);
+            predicciones++;
+            if (it != mejor.end() && it->second.first == actual) aciertos++;
+            uint64_t clave = (uint64_t)anterior->word << 32 | actual->word;
+            uint32_t c = ++conteos[clave];
+            auto& m = mejor[anterior];
+            if (c > m.second) m = {actual, c};
+        }
+        anterior = actual;
+    }
+    cout << "Conteo exacto: aciertos top-1 " << (double)aciertos / predicciones * 100 << "%, "
+         << conteos.size() << " bigramas distintos (" << (double)conteos.size() * 12 / mejor.size()
+         << " bytes por palabra sólo en claves y conteos)\n";
+
+    // un sucesor borrado no debe pasar a predecirse como la palabra que reutilice
+    // su id, ni las altas y bajas repetidas deben hacer crecer la memoria
+    Trie churn(FREQUENCY);
+    churn.enable_successors(4);
+    TrieNode* the = churn.insert("the");
+    churn.observe_successor(the, churn.insert("cat"));
+    churn.observe_successor(the, churn.insert("sat"));
+    churn.observe_successor(churn.insert("cat"), the);
+    size_t memoria = 0;
+    for (int ronda = 0; ronda < 100; ++ronda) {
+        churn.remove("cat");
+        churn.insert("dog");
+        vector<TrieNode*> tras = churn.predict_next(churn.find_prefix("the"), 4);
+        if (tras.size() != 1 || churn.get_word(tras[0]) != "sat") {
+            throw runtime_error("compararSucesores: tras borrar \"cat\" se predice una palabra que no siguió a \"the\"");
+        }
+        if (!churn.predict_next(churn.find_prefix("dog"), 4).empty()) {
+            throw runtime_error("compararSucesores: \"dog\" heredó los sucesores de \"cat\"");
+        }
+        churn.remove("dog");
+        churn.observe_successor(churn.find_prefix("the"), churn.insert("cat"));
+        if (ronda == 1) memoria = churn.memory_bytes();
+        if (ronda > 1 && churn.memory_bytes() != memoria) {
+            throw runtime_error("compararSucesores: borrar y reinsertar palabras hace crecer la memoria");
+        }
+    }
+    cout << "Borrar y reinsertar con sucesores: sin predicciones ajenas ni crecimiento de memoria\n";
+    cout << " === === \n";
+}
+
+/**
+ * @brief Compara capas por usuario (`UserOverlay`) sobre una base compartida
+ * con un Trie completo por usuario.
+ *
+ * La base es el diccionario entrenado con la primera mitad del texto. Cada
+ * usuario escribe un tramo distinto de la segunda mitad. Se mide la memoria
+ * por usuario, el costo de cada uso y de cada consulta (prefijos de largo 1
+ * a 3) frente a consultar un Trie propio, y para los primeros usuarios se
+ * verifica contra un Trie completo entrenado igual que base + usuario.
+ *
+ * @param rutaPalabras Diccionario.
+ * @param rutaTexto Texto con los usos.
+ * @param variante Variante de prioridad.
+ * @param usuarios Cantidad de usuarios.
+ */
+inline void compararOverlay(const string& rutaPalabras, const string& rutaTexto, int variante, uint32_t usuarios) {
+    MappedFile texto(rutaTexto);
+    vector<string_view> usos = separarPalabras(texto);
+    size_t mitad = usos.size() / 2;
+    size_t tramo = (usos.size() - mitad) / usuarios;
+    auto entrenar = [&](Trie& t) {
+        cargarSilencioso(t, rutaPalabras);
+        for (size_t i = 0; i < mitad; ++i) t.update_priority(t.insert(usos[i]));
+    };
+
+    Trie base(variante);
+    entrenar(base);
+
+    vector<unique_ptr<UserOverlay>> capas;
+    chrono::duration<double> t_usar{0};
+    for (uint32_t u = 0; u < usuarios; ++u) {
+        capas.push_back(make_unique<UserOverlay>(base));
+        auto t0 = chrono::high_resolution_clock::now();
+        for (size_t i = mitad + u * tramo; i < mitad + (u + 1) * tramo; ++i) capas.back()->use(usos[i]);
+        t_usar += chrono::high_resolution_clock::now() - t0;
+    }
+    size_t bytes_capas = 0;
+    uint64_t palabras_capas = 0;
+    for (const auto& c : capas) {
+        bytes_capas += c->memory_bytes();
+        palabras_capas += c->user_words();
+    }
+    cout << usuarios << " usuarios, " << tramo << " palabras escritas por usuario; Trie completo: "
+         << base.memory_bytes() << " bytes por usuario, capa: " << bytes_capas / usuarios << " bytes por usuario ("
+         << palabras_capas / usuarios << " palabras, " << (double)base.memory_bytes() * usuarios / (base.memory_bytes() + bytes_capas)
+         << "x menos memoria en total)\n";
+    cout << "Uso en la capa: " << t_usar.count() * 1e9 / (tramo * usuarios) << " ns\n";
+
+    uint64_t consultas = 0, con_sugerencia = 0;
+    chrono::duration<double> t_capa{0}, t_base{0};
+    for (uint32_t u = 0; u < usuarios; ++u) {
+        for (size_t i = mitad + u * tramo; i < mitad + (u + 1) * tramo; ++i) {
+            for (size_t l = 1; l <= 3 && l <= usos[i].size(); ++l) {
+                string_view p = usos[i].substr(0, l);
+                auto t0 = chrono::high_resolution_clock::now();
+                string_view a = capas[u]->autocomplete(p);
+                auto t1 = chrono::high_resolution_clock::now();
+                TrieNode* b = base.autocomplete(base.find_prefix(p));
+                auto t2 = chrono::high_resolution_clock::now();
+                t_capa += t1 - t0;
+                t_base += t2 - t1;
+                consultas++;
+                con_sugerencia += !a.empty() + (b != nullptr);
+            }
+        }
+    }
+    cout << "Consulta combinada: " << t_capa.count() * 1e9 / consultas << " ns, Trie propio: "
+         << t_base.count() * 1e9 / consultas << " ns (" << con_sugerencia << " sugerencias en " << consultas
+         << " consultas x 2)\n";
+
+    uint64_t revisadas = 0, iguales = 0;
+    for (uint32_t u = 0; u < usuarios && u < 3; ++u) {
+        Trie copia(variante);
+        entrenar(copia);
+        for (size_t i = mitad + u * tramo; i < mitad + (u + 1) * tramo; ++i) copia.update_priority(copia.insert(usos[i]));
+        for (size_t i = mitad + u * tramo; i < mitad + (u + 1) * tramo; ++i) {
+            for (size_t l = 1; l <= 3 && l <= usos[i].size(); ++l) {
+                string_view p = usos[i].substr(0, l);
+                TrieNode* esperada = copia.autocomplete(copia.find_prefix(p));
+                string_view obtenida = capas[u]->autocomplete(p);
+                revisadas++;
+                if ((esperada ? esperada->priority : 0) == (obtenida.empty() ? 0 : capas[u]->priority(obtenida))) iguales++;
+            }
+        }
+    }
+    cout << "Sugerencias iguales a las de un Trie completo por usuario: " << iguales << "/" << revisadas << "\n";
+    cout << " === === \n";
+}
+
+#endif // EXPERIMENTOS_HPP
@@ -4,7 +4,8 @@
  *
  * Contiene una ventana de selección de modo/dataset y un editor con sugerencias
  * de autocompletado. Las acciones principales son:
- * - Inicializar un `Trie` con un dataset seleccionado.
+ * - Inicializar un `Trie` con un dataset seleccionado (recuperando las
+ *   prioridades aprendidas en sesiones anteriores, ver `DurableTrie`).
  * - Mostrar sugerencias basadas en el prefijo actual.
  * - Aceptar sugerencias con TAB o actualizar/insertar palabras con ENTER.
  *
@@ -18,7 +19,8 @@
 #include <nana/gui/place.hpp>
 #include <nana/gui/widgets/combox.hpp>
 #include <iostream>
-#include "trie.hpp"
+#include <memory>
+#include "durable_trie.hpp"
 #include "utils.hpp"
 
 using namespace nana;
@@ -97,6 +99,46 @@ nana::upoint indice_a_caret(size_t indice, const std::string &texto) {
     return nana::upoint{columna, linea};
 }
 
+/**
+ * @brief Mejor sugerencia para un prefijo que no existe en el Trie (error de tipeo).
+ *
+ * Admite 1 edición en prefijos de hasta 4 caracteres y 2 en los más largos,
+ * para que un prefijo corto no calce con casi cualquier palabra.
+ *
+ * @param trie Trie donde se busca.
+ * @param prefijo Prefijo escrito.
+ * @return Terminal sugerido o `nullptr`.
+ */
+TrieNode* sugerencia_difusa(DurableTrie &trie, const std::string &prefijo) {
+    if (prefijo.empty()) return nullptr;
+    uint32_t ediciones = prefijo.size() <= 4 ? 1 : 2;
+    std::vector<TrieNode*> mejores = trie.fuzzy_autocomplete(prefijo, ediciones, 1);
+    return mejores.empty() ? nullptr : mejores[0];
+}
+
+/**
+ * @brief Terminal de `palabra` o `nullptr` si no es una palabra del Trie.
+ *
+ * @param trie Trie donde se busca.
+ * @param palabra Palabra completa.
+ * @return Nodo terminal o `nullptr`.
+ */
+TrieNode* buscar_palabra(DurableTrie &trie, const std::string &palabra) {
+    TrieNode* nodo = trie.get_root();
+    for (char c : palabra) {
+        nodo = trie.descend(nodo, c);
+        if (!nodo) return nullptr;
+    }
+    return trie.is_terminal(nodo) ? nodo : nullptr;
+}
+
+/**
+ * @brief Indica si el texto termina en separador (no hay palabra en curso).
+ */
+bool termina_en_separador(const std::string &texto) {
+    return !texto.empty() && (texto.back() == ' ' || texto.back() == '\n' || texto.back() == '\t');
+}
+
 
 int main() {
     
@@ -197,7 +239,11 @@ int main() {
     // ==========================================
     // VARIABLES DEL TRIE
     // ==========================================
-    Trie* trie = nullptr;
+    DurableTrie* trie = nullptr;
+    std::unique_ptr<TrieCursor> cursor;   // prefijo de la palabra que se está escribiendo
+    bool cursor_sincronizado = false;     // el caret está al final del texto y el cursor refleja la última palabra
+    bool tecla_pendiente = false;         // el próximo text_changed viene de una tecla ya aplicada al cursor
+    TrieNode* palabra_previa = nullptr;   // última palabra completa, para predecir la siguiente
     std::string dataset_actual = "datasets/words.txt"; // Dataset por defecto
     
         // Evento para cambiar el dataset
@@ -219,14 +265,39 @@ int main() {
         std::cout << "Dataset seleccionado: " << dataset_actual << std::endl;
     });
 
-    // Función para inicializar el Trie con el dataset
+    // Función para inicializar el Trie con el dataset. El Trie entrenado y las
+    // prioridades que se aprenden al escribir se guardan junto al dataset.
     auto inicializar_trie = [&](int variante) {
+        cursor.reset();
+        palabra_previa = nullptr;
         if (trie != nullptr) {
             delete trie;
         }
-        trie = new Trie(variante);
-        recorrer(*trie, dataset_actual);
-        std::cout << "Trie inicializado con variante " << variante 
+        // Snapshot base + log de actualizaciones: sólo la primera vez se
+        // recorre el dataset completo.
+        std::string ruta = dataset_actual + (variante == RECENT ? ".reciente" : ".frecuencia");
+        try {
+            trie = new DurableTrie(ruta, variante);
+        } catch (const std::exception& e) {
+            std::cout << "Estado guardado inutilizable (" << e.what() << "), se recorre el dataset" << std::endl;
+            DurableTrie::discard(ruta);
+            trie = new DurableTrie(ruta, variante);
+        }
+
+        if (trie->is_new()) {
+            trie->enable_successors(4);   // predicción de la palabra siguiente
+            recorrer(trie->trie(), dataset_actual);
+            try {
+                trie->checkpoint();
+            } catch (const std::exception& e) {
+                std::cout << "No se pudo guardar el snapshot: " << e.what() << std::endl;
+            }
+        } else {
+            std::cout << "Recuperado desde el log (" << trie->replayed_records() << " registros repetidos)" << std::endl;
+        }
+        cursor = std::make_unique<TrieCursor>(trie->trie());
+        cursor_sincronizado = false;
+        std::cout << "Trie inicializado con variante " << variante
                 << " y dataset: " << dataset_actual << std::endl;
     };
     
@@ -259,33 +330,45 @@ int main() {
     auto actualizar_sugerencia = [&]() {
         if (!trie) return;
 
-        std::string texto_completo = txt_editor.text();
-        std::string prefijo = obtener_ultima_palabra(texto_completo);
-
-        // No mostrar sugerencias si no hay prefijo válido o si el texto termina en separador
-        if (prefijo.empty() || texto_completo.empty() ||
-            texto_completo.back() == ' ' ||
-            texto_completo.back() == '\n' ||
-            texto_completo.back() == '\t') {
-            txt_sugerencia.caption("(No hay prefijo)");
-            return;
-        }
+        if (tecla_pendiente) {
+            // La tecla ya se aplicó al cursor: O(1), sin copiar el texto
+            tecla_pendiente = false;
+        } else {
+            // Pegado, edición a mitad del texto, TAB, etc.: se rearma el
+            // cursor desde la última palabra del texto completo
+            std::string texto_completo = txt_editor.text();
+            std::string prefijo = obtener_ultima_palabra(texto_completo);
 
-        // Navegar por el Trie con el prefijo
-        TrieNode* nodo = trie->get_root();
-        for (char c : prefijo) {
-            nodo = trie->descend(nodo, c);
-            if (!nodo) break;
+            cursor->reset();
+            // No hay prefijo válido si el texto termina en separador: la
+            // última palabra pasa a ser la anterior a la que se escribirá
+            palabra_previa = nullptr;
+            if (termina_en_separador(texto_completo)) {
+                palabra_previa = buscar_palabra(*trie, prefijo);
+            } else if (!texto_completo.empty()) {
+                for (char c : prefijo) cursor->push(c);
+            }
+            cursor_sincronizado = caret_a_indice(txt_editor.caret_pos(), texto_completo) == texto_completo.size();
         }
 
-        if (nodo) {
-            TrieNode* mejor = trie->autocomplete(nodo);
+        if (cursor->depth() == 0) {
+            std::vector<TrieNode*> siguiente = trie->predict_next(palabra_previa, 1);
+            if (!siguiente.empty())
+                txt_sugerencia.caption("Siguiente: " + trie->get_str(siguiente[0]));
+            else
+                txt_sugerencia.caption("(No hay prefijo)");
+        } else if (!cursor->node()) {
+            TrieNode* parecida = sugerencia_difusa(*trie, obtener_ultima_palabra(txt_editor.text()));
+            if (parecida)
+                txt_sugerencia.caption("Quizas: " + trie->get_str(parecida));
+            else
+                txt_sugerencia.caption("(Palabra no encontrada)");
+        } else {
+            TrieNode* mejor = cursor->best();
             if (mejor)
-                txt_sugerencia.caption(mejor->get_str());
+                txt_sugerencia.caption(trie->get_str(mejor));
             else
                 txt_sugerencia.caption("(Sin sugerencia)");
-        } else {
-            txt_sugerencia.caption("(Palabra no encontrada)");
         }
     };
     
@@ -296,6 +379,37 @@ int main() {
     txt_editor.events().text_changed([&]{
         actualizar_sugerencia();
     });
+
+
+    // ==========================================
+    // EVENTO: Caracteres escritos al final del texto
+    // ==========================================
+    // Se aplican al cursor directamente (push/pop/reset). Si no se puede
+    // asegurar que la tecla sólo agrega o borra al final de la última
+    // palabra, no se marca `tecla_pendiente` y text_changed rearma el cursor.
+    txt_editor.events().key_char([&](const arg_keyboard& arg) {
+        if (!trie || arg.ignore || !cursor_sincronizado || txt_editor.selected()) return;
+
+        wchar_t k = arg.key;
+        if (k == keyboard::backspace) {
+            if (cursor->depth() == 0) return;   // borra un separador: la palabra anterior vuelve a ser el prefijo
+            cursor->pop();
+        } else if (k == ' ' || k == '\n' || k == '\r') {
+            // la palabra recién escrita es la anterior a la próxima (un separador repetido no la cambia)
+            if (cursor->depth() > 0) palabra_previa = trie->is_terminal(cursor->node()) ? cursor->node() : nullptr;
+            cursor->reset();
+        } else if (k > ' ' && k < 0x7f) {
+            cursor->push(static_cast<char>(k));
+        } else {
+            return;
+        }
+        tecla_pendiente = true;
+    });
+
+    // Mover el caret deja de escribir al final del texto
+    txt_editor.events().mouse_down([&](const arg_mouse&) {
+        cursor_sincronizado = false;
+    });
     
     
     // ==========================================
@@ -303,6 +417,14 @@ int main() {
     // ==========================================
     txt_editor.events().key_press([&](const arg_keyboard& arg) -> bool {
         if (!trie) return false;
+        tecla_pendiente = false;
+
+        // Flechas, inicio/fin, página, insertar y suprimir mueven el caret o
+        // borran hacia adelante
+        if (arg.key >= keyboard::os_pageup && arg.key <= keyboard::os_del) {
+            cursor_sincronizado = false;
+            return false;
+        }
 
         // ========== TAB: Autocompletar ==========
         if (arg.key == keyboard::tab) {
@@ -316,48 +438,56 @@ int main() {
                 return true;
             }
 
-            // Buscar el nodo del prefijo
-            TrieNode* nodo = trie->get_root();
-            for (char c : prefijo) {
-                nodo = trie->descend(nodo, c);
-                if (!nodo) break;
-            }
-
-            if (nodo) {
-                TrieNode* mejor = trie->autocomplete(nodo);
-                if (mejor) {
-                    // Obtener posición del caret
-                    nana::upoint caret = txt_editor.caret_pos();
-                    size_t pos_absoluta = caret_a_indice(caret, texto_completo);
-
-                    // Dividir texto antes y después del caret
-                    std::string antes = texto_completo.substr(0, pos_absoluta);
-                    std::string despues = texto_completo.substr(pos_absoluta);
-
-                    // Buscar inicio de la última palabra antes del caret
-                    auto inicio = antes.find_last_of(" \t\n");
-                    if (inicio == std::string::npos) inicio = 0;
-                    else inicio += 1;
-
-                    // Construir nuevo texto con la palabra completada
-                    std::string nuevo_texto = antes.substr(0, inicio) + mejor->get_str() + " " + despues;
-                    txt_editor.caption(nuevo_texto);
-
-                    // Insertar palabra en el trie y actualizar prioridad
-                    trie->insert(mejor->get_str());
-                    trie->update_priority(mejor);
-
-                    // Reposicionar el caret al final de la palabra insertada
-                    size_t nueva_pos = inicio + mejor->get_str().size() + 1;
-                    nana::upoint nuevo_caret = indice_a_caret(nueva_pos, nuevo_texto);
-                    txt_editor.caret_pos(nuevo_caret);
-
-                    // Limpiar sugerencia
-                    txt_sugerencia.caption("(Palabra aceptada)");
-                    txt_editor.focus();
-
-                    std::cout << "TAB: Palabra completada -> " << mejor->get_str() << std::endl;
+            TrieNode* mejor = nullptr;
+            if (termina_en_separador(texto_completo)) {
+                // Sin palabra en curso: se agrega la palabra siguiente predicha
+                std::vector<TrieNode*> siguiente = trie->predict_next(buscar_palabra(*trie, prefijo), 1);
+                if (!siguiente.empty()) mejor = siguiente[0];
+            } else {
+                // Buscar el nodo del prefijo
+                TrieNode* nodo = trie->get_root();
+                for (char c : prefijo) {
+                    nodo = trie->descend(nodo, c);
+                    if (!nodo) break;
                 }
+
+                // Si el prefijo no existe se completa con la sugerencia tolerante a errores
+                mejor = nodo ? trie->autocomplete(nodo) : sugerencia_difusa(*trie, prefijo);
+            }
+            if (mejor) {
+                // Obtener posición del caret
+                nana::upoint caret = txt_editor.caret_pos();
+                size_t pos_absoluta = caret_a_indice(caret, texto_completo);
+
+                // Dividir texto antes y después del caret
+                std::string antes = texto_completo.substr(0, pos_absoluta);
+                std::string despues = texto_completo.substr(pos_absoluta);
+
+                // Buscar inicio de la última palabra antes del caret
+                auto inicio = antes.find_last_of(" \t\n");
+                if (inicio == std::string::npos) inicio = 0;
+                else inicio += 1;
+
+                // Construir nuevo texto con la palabra completada
+                std::string nuevo_texto = antes.substr(0, inicio) + trie->get_str(mejor) + " " + despues;
+                txt_editor.caption(nuevo_texto);
+
+                // Insertar palabra en el trie, actualizar prioridad y aprender el bigrama
+                trie->insert(trie->get_str(mejor));
+                trie->update_priority(mejor);
+                trie->observe_successor(buscar_palabra(*trie, obtener_ultima_palabra(antes.substr(0, inicio))), mejor);
+
+                // Reposicionar el caret al final de la palabra insertada
+                size_t nueva_pos = inicio + trie->get_str(mejor).size() + 1;
+                nana::upoint nuevo_caret = indice_a_caret(nueva_pos, nuevo_texto);
+                txt_editor.caret_pos(nuevo_caret);
+                cursor_sincronizado = false;   // el texto se rearmó: la próxima tecla resincroniza
+
+                // Limpiar sugerencia
+                txt_sugerencia.caption("(Palabra aceptada)");
+                txt_editor.focus();
+
+                std::cout << "TAB: Palabra completada -> " << trie->get_str(mejor) << std::endl;
             }
 
             // Evitar que el tab inserte un carácter tabulación
@@ -383,12 +513,18 @@ int main() {
                 }
 
                 if (!existe || !nodo->is_terminal) {
-                    trie->insert(prefijo);
+                    nodo = trie->insert(prefijo);
                     std::cout << "ENTER: Palabra nueva insertada -> " << prefijo << std::endl;
                 } else {
                     trie->update_priority(nodo);
                     std::cout << "ENTER: Prioridad actualizada -> " << prefijo << std::endl;
                 }
+
+                // Bigrama con la palabra anterior (si la palabra recién se terminó de escribir)
+                if (!termina_en_separador(texto_completo)) {
+                    std::string anterior = texto_completo.substr(0, texto_completo.size() - prefijo.size());
+                    trie->observe_successor(buscar_palabra(*trie, obtener_ultima_palabra(anterior)), nodo);
+                }
             }
 
             // Limpiar sugerencia y dejar que Nana maneje el salto de línea
@@ -403,15 +539,19 @@ int main() {
     // Eventos de cierre
     // ==========================================
     fm_selector.events().unload([&](const arg_unload&){
+        cursor.reset();
         if (trie != nullptr) {
             delete trie;
+            trie = nullptr;
         }
         API::exit();
     });
     
     fm_editor.events().unload([&](const arg_unload&){
+        cursor.reset();
         if (trie != nullptr) {
             delete trie;
+            trie = nullptr;
         }
         API::exit();
     });
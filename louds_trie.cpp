@@ -0,0 +1,101 @@
+/**
+ * @file louds_trie.cpp
+ * @brief Construcción y navegación del Trie sucinto (LOUDS).
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#include "louds_trie.hpp"
+#include "utils.hpp"
+#include <algorithm>
+
+/**
+ * @brief Recorre `t` por niveles desde la raíz y escribe cada estructura.
+ *
+ * Los hijos de cada nodo se visitan en orden de símbolo, de modo que las
+ * etiquetas de un grupo de hermanos quedan ordenadas. Sólo se recorre lo
+ * alcanzable desde la raíz (los nodos inertes de `build_parallel` no entran).
+ *
+ * @param t Trie de origen.
+ */
+LoudsTrie::LoudsTrie(const Trie& t) {
+    vector<uint32_t> orden{t.root};         // índice en el pool de cada nodo, por niveles
+    vector<uint8_t> simbolo{0};             // etiqueta de la arista entrante
+    vector<pair<uint8_t, uint32_t>> hijos;
+
+    for (size_t i = 0; i < orden.size(); ++i) {
+        hijos.clear();
+        t.children.for_each(t.nodes[orden[i]].children,
+                            [&](uint8_t key, uint32_t child) { hijos.push_back({key, child}); });
+        sort(hijos.begin(), hijos.end());
+        for (const auto& h : hijos) {
+            louds.push_back(true);
+            orden.push_back(h.second);
+            simbolo.push_back(h.first);
+        }
+        louds.push_back(false);
+    }
+    louds.seal();
+    nodes = (uint32_t)orden.size();
+
+    // número de cada nodo y de cada palabra
+    vector<uint32_t> numero(t.nodes.size(), 0);
+    vector<uint32_t> palabra(nodes + 1, 0);
+    uint32_t total = 0;
+    uint64_t largo = 0;
+    for (uint32_t v = 1; v <= nodes; ++v) {
+        const TrieNode& n = t.nodes[orden[v - 1]];
+        numero[orden[v - 1]] = v;
+        terminals.push_back(n.is_terminal);
+        if (n.is_terminal) {
+            palabra[v] = ++total;
+            largo += t.words.get(n.word).size();
+        }
+    }
+    terminals.seal();
+
+    labels = PackedArray(nodes + 1, 5);
+    best = PackedArray(nodes + 1, PackedArray::bits_for(total));
+    offsets = PackedArray(total + 1, PackedArray::bits_for(largo));
+    chars.reserve(largo);
+
+    for (uint32_t v = 1; v <= nodes; ++v) {
+        const TrieNode& n = t.nodes[orden[v - 1]];
+        labels.set(v, simbolo[v - 1]);
+        if (n.best_terminal) best.set(v, palabra[numero[n.best_terminal]]);
+        if (n.is_terminal) {
+            offsets.set(palabra[v] - 1, (uint32_t)chars.size());
+            string_view w = t.words.get(n.word);
+            chars.insert(chars.end(), w.begin(), w.end());
+        }
+    }
+    offsets.set(total, (uint32_t)chars.size());
+}
+
+/**
+ * @brief Desciende un carácter.
+ *
+ * El bloque del nodo `v` en LOUDS empieza después del cero número `v - 1` y
+ * termina en el siguiente cero; el primer 1 del bloque corresponde al hijo
+ * número `unos_previos + 2` (la raíz no tiene arista entrante). Las etiquetas
+ * de los hermanos están ordenadas, así que la búsqueda se corta apenas pasa
+ * del símbolo buscado.
+ *
+ * @param v Nodo de partida.
+ * @param c Carácter a seguir.
+ * @return Hijo o 0.
+ */
+uint32_t LoudsTrie::descend(uint32_t v, const char c) const {
+    if (!v) return 0;
+    uint64_t inicio = (v == 1) ? 0 : louds.select0(v - 1) + 1;
+    uint64_t fin = louds.next0(inicio);
+    uint32_t primero = (uint32_t)(inicio - (v - 1) + 2);
+    uint32_t key = (uint32_t)charToIndex(c);
+
+    for (uint32_t hijo = primero; hijo < primero + (fin - inicio); ++hijo) {
+        uint32_t l = labels.get(hijo);
+        if (l == key) return hijo;
+        if (l > key) break;
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file louds_trie.hpp
+ * @brief Trie de sólo lectura en representación sucinta (LOUDS).
+ *
+ * Se construye una vez a partir de un `Trie` ya entrenado y después no
+ * cambia. La forma del árbol se guarda como LOUDS (Level-Order Unary Degree
+ * Sequence): recorriendo los nodos por niveles, cada nodo escribe un 1 por
+ * hijo y luego un 0. Los nodos se numeran en ese mismo orden (la raíz es 1),
+ * así que los hijos de un nodo tienen números consecutivos y se encuentran
+ * con un `select0`, sin guardar punteros.
+ *
+ * Por nodo quedan: 2 bits de LOUDS, la etiqueta de la arista entrante en 5
+ * bits (los 27 símbolos de `charToIndex`), 1 bit de terminal y el id de su
+ * mejor terminal en ceil(log2(palabras + 1)) bits. Las palabras van aparte,
+ * concatenadas en orden de id.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef LOUDS_TRIE_HPP
+#define LOUDS_TRIE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "succinct.hpp"
+#include "trie.hpp"
+
+using namespace std;
+
+/**
+ * @brief Trie congelado con la misma semántica de `descend` y `autocomplete`
+ * que el `Trie` del que se construyó.
+ *
+ * Los nodos se identifican por su número en orden por niveles (0 = nulo).
+ * `autocomplete` entrega un id de palabra (0 = sin sugerencia) que se traduce
+ * con `get_word`. Todas las consultas son `const` y pueden hacerse desde
+ * varios hilos a la vez sin sincronización.
+ */
+class LoudsTrie {
+    public:
+    /**
+     * @brief Congela el estado actual de `t` (palabras y mejores terminales).
+     * @param t Trie de origen; no se modifica.
+     */
+    explicit LoudsTrie(const Trie& t);
+
+    /**
+     * @brief Devuelve la raíz.
+     */
+    uint32_t get_root() const { return 1; }
+
+    /**
+     * @brief Desciende desde el nodo `v` siguiendo el carácter `c`.
+     * @param v Nodo de partida (0 = nulo).
+     * @param c Carácter a seguir.
+     * @return Nodo hijo o 0 si no existe.
+     */
+    uint32_t descend(uint32_t v, const char c) const;
+
+    /**
+     * @brief Mejor terminal del subárbol de `v` al momento de congelar.
+     * @param v Nodo desde el cual se consulta.
+     * @return Id de la palabra sugerida o 0 si no hay.
+     */
+    uint32_t autocomplete(uint32_t v) const { return v ? best.get(v) : 0; }
+
+    /**
+     * @brief Indica si el nodo `v` representa una palabra completa.
+     */
+    bool is_terminal(uint32_t v) const { return v && terminals[v - 1]; }
+
+    /**
+     * @brief Id de la palabra de un nodo terminal (0 si no es terminal).
+     */
+    uint32_t word_id(uint32_t v) const { return is_terminal(v) ? (uint32_t)terminals.rank1(v) : 0; }
+
+    /**
+     * @brief Palabra de un id entregado por `autocomplete` o `word_id`.
+     * @param id Id de palabra.
+     * @return Palabra o cadena vacía si `id` es 0.
+     */
+    string_view get_word(uint32_t id) const {
+        if (!id) return string_view();
+        uint32_t inicio = offsets.get(id - 1);
+        return string_view(chars.data() + inicio, offsets.get(id) - inicio);
+    }
+
+    /**
+     * @brief Igual que `get_word` pero copiando la palabra.
+     */
+    string get_str(uint32_t id) const { return string(get_word(id)); }
+
+    /**
+     * @brief Devuelve el número de nodos (incluye la raíz).
+     */
+    uint32_t get_size() const { return nodes; }
+
+    /**
+     * @brief Cantidad de palabras.
+     */
+    uint32_t get_words() const { return (uint32_t)(offsets.size() - 1); }
+
+    /** @brief Bytes de la forma del árbol: LOUDS, etiquetas y bits de terminal. */
+    size_t structure_bytes() const { return louds.bytes() + labels.bytes() + terminals.bytes(); }
+
+    /** @brief Bytes del arreglo de mejores terminales. */
+    size_t best_bytes() const { return best.bytes(); }
+
+    /** @brief Bytes de las palabras y sus desplazamientos. */
+    size_t words_bytes() const { return chars.size() + offsets.bytes(); }
+
+    /**
+     * @brief Devuelve la memoria total ocupada.
+     * @return Cantidad de bytes.
+     */
+    size_t memory_bytes() const { return structure_bytes() + best_bytes() + words_bytes(); }
+
+private:
+    BitVector louds;        /**< Grados en unario, por niveles */
+    PackedArray labels;     /**< Símbolo de la arista que llega a cada nodo (5 bits) */
+    BitVector terminals;    /**< Bit `v - 1`: el nodo `v` es terminal */
+    PackedArray best;       /**< Id del mejor terminal de cada nodo */
+    vector<char> chars;     /**< Palabras concatenadas en orden de id */
+    PackedArray offsets;    /**< Inicio de cada palabra en `chars` (más el final) */
+    uint32_t nodes;         /**< Cantidad de nodos */
+};
+
+#endif
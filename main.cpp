@@ -6,6 +6,7 @@
 #include <nana/gui/widgets/textbox.hpp>
 #include "trie.hpp"
 #include "utils.hpp"
+#include "experimentos.hpp"
 #include <iostream>
 
 using namespace std;
@@ -24,6 +25,75 @@ int main() {
         Trie words_rec_3(FREQUENCY);
 
 
+        cout << " === Throughput de lectura (ifstream vs mmap), dataset: Wikipedia === \n\n";
+        compararLectura("datasets/wikipedia.txt");
+
+        cout << " === Normalizacion de mayusculas y puntuacion (escalar vs SIMD), dataset: Wikipedia === \n\n";
+        compararNormalizacion("datasets/wikipedia.txt");
+
+        cout << " === Comparacion de layouts de nodos (fijo vs adaptativo), dataset: Words === \n\n";
+        compararLayouts("datasets/words.txt");
+
+        cout << " === Carga palabra por palabra vs build_sorted, dataset: Words === \n\n";
+        compararCargaOrdenada("datasets/words.txt");
+
+        cout << " === Construccion en paralelo por prefijos, dataset: Words === \n\n";
+        compararConstruccionParalela("datasets/words.txt");
+
+        cout << " === Lectores concurrentes con un escritor (epocas), dataset: Words + Wikipedia === \n\n";
+        compararConcurrencia("datasets/words.txt", "datasets/wikipedia.txt");
+
+        cout << " === Reconstruir vs cargar snapshot binario, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararSnapshot("datasets/words.txt", "datasets/wikipedia.txt", "datasets/wikipedia.frecuencia.trie", FREQUENCY);
+
+        cout << " === Log de prioridades: group commit y recuperacion, dataset: Words + Wikipedia [Variante: Reciente] === \n\n";
+        compararRecuperacion("datasets/words.txt", "datasets/wikipedia.txt", "datasets/wikipedia.reciente.log", RECENT);
+
+        cout << " === Trie vs LOUDS de solo lectura, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararLouds("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Trie vs automata minimo (DAWG), dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararDawg("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Sugerencia por tecla: descender desde la raiz vs TrieCursor, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararCursor("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Busqueda por lotes intercalada (AMAC), dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararLotes("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Tabla de prefijos cortos (L = 2..5), dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararSaltos("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Reordenamiento de nodos (compact), dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararCompactacion("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Politica de prioridad en ejecucion vs en compilacion, dataset: Words + Wikipedia === \n\n";
+        compararPoliticas("datasets/words.txt", "datasets/wikipedia.txt");
+
+        cout << " === RECENT con propagacion perezosa, dataset: Words + Wikipedia === \n\n";
+        compararRecientePerezoso("datasets/words.txt", "datasets/wikipedia.txt");
+
+        cout << " === Borrado y baja de prioridades con reparacion local, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararEliminacion("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY);
+
+        cout << " === Autocompletado con errores de tipeo, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararDifuso("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY, 5);
+
+        cout << " === Prediccion de la siguiente palabra con tablas de sucesores, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararSucesores("datasets/words.txt", "datasets/wikipedia.txt");
+
+        cout << " === Capas por usuario sobre un Trie base compartido, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararOverlay("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY, 200);
+
+        cout << " === Comparacion Trie vs Trie comprimido (radix), dataset: Words + Wikipedia [Variante: Reciente] === \n\n";
+        compararCompresion("datasets/words.txt", "datasets/wikipedia.txt", RECENT);
+
+        cout << " === Top-k por nodo vs recorrido del subarbol, dataset: Words + Wikipedia [Variante: Frecuencia] === \n\n";
+        compararTopK("datasets/words.txt", "datasets/wikipedia.txt", FREQUENCY, 10);
+
+        cout << " === Top-k por nodo vs recorrido del subarbol, dataset: Words + Wikipedia [Variante: Reciente] === \n\n";
+        compararTopK("datasets/words.txt", "datasets/wikipedia.txt", RECENT, 10);
+
         cout << " === Analisis de consumo de memoria y tiempo, dataset: Words === \n\n";    
         cargarArchivoPalabras(words_freq, "datasets/words.txt");
 
@@ -33,6 +103,7 @@ int main() {
 
         cout << " === Analisis de autocompletado para dataset: Wikipedia [Variante: Frecuencia] === \n\n";
 
+        words_freq.enable_successors(4);
         auto start1 = std::chrono::high_resolution_clock::now();        
         recorrer(words_freq, "datasets/wikipedia.txt");
         auto end1 = std::chrono::high_resolution_clock::now();
@@ -47,6 +118,23 @@ int main() {
         std::chrono::duration<double> elapsed_seconds2 = end2 - start2;
         cout << "Tiempo en simular analisis: " << elapsed_seconds2.count() << " segundos \n";
 
+        cout << " === Analisis de autocompletado para dataset: Wikipedia [Variante: Frecuencia con decaimiento] === \n\n";
+
+        Trie words_dec(DECAYED);
+        cargarArchivoPalabras(words_dec, "datasets/words.txt");
+
+        auto start_dec = std::chrono::high_resolution_clock::now();        
+        recorrer(words_dec, "datasets/wikipedia.txt");
+        auto end_dec = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_seconds_dec = end_dec - start_dec;
+        cout << "Tiempo en simular analisis: " << elapsed_seconds_dec.count() << " segundos \n";
+
+        cout << " === Analisis de autocompletado para dataset: Wikipedia normalizado [Variante: Reciente] === \n\n";
+
+        Trie words_rec_norm(RECENT);
+        cargarArchivoPalabras(words_rec_norm, "datasets/words.txt", true);
+        recorrer(words_rec_norm, "datasets/wikipedia.txt", true);
+
         cout << " === Analisis de autocompletado para dataset: Random [Variante: Frecuencia]=== \n\n";
 
         auto start3 = std::chrono::high_resolution_clock::now();        
@@ -0,0 +1,79 @@
+/**
+ * @file overlay.cpp
+ * @brief Usos y consultas de `UserOverlay` sobre el Trie base.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#include "overlay.hpp"
+
+/**
+ * @brief Crea la capa con la variante y el contador de la base.
+ * @param b Trie base.
+ */
+UserOverlay::UserOverlay(Trie& b) : base(b), user(b.variant), words(0), rescales(0) {
+    user.advance_counter(base.get_counter());
+}
+
+/**
+ * @brief Copia la palabra a la capa en su primer uso (con la prioridad que
+ * tiene en la base) y aplica el uso ahí.
+ * @param w Palabra usada.
+ */
+void UserOverlay::use(string_view w) {
+    TrieNode* v = user.find_prefix(w);
+    if (!user.is_terminal(v)) {
+        v = user.insert(w);
+        words++;
+        TrieNode* b = base.find_prefix(w);
+        if (base.is_terminal(b) && b->priority > 0) user.set_priority(w, base_priority(b));
+    }
+    uint32_t antes = user.get_counter();
+    user.update_priority(v);
+    if (user.get_counter() < antes) rescales++;  // sólo un reescalado hace retroceder el contador
+}
+
+/**
+ * @brief Combina la mejor sugerencia de la base con la de la capa.
+ *
+ * No hace falta revisar si el usuario tocó la mejor de la base: si la tocó,
+ * su prioridad efectiva (no menor que la de la base) está en la capa bajo el
+ * mismo prefijo, así que la mejor de la capa la empata o le gana.
+ *
+ * @param prefijo Prefijo escrito.
+ * @return Palabra sugerida (vacía si no hay).
+ */
+string_view UserOverlay::autocomplete(string_view prefijo) {
+    TrieNode* mejor_base = base.autocomplete(base.find_prefix(prefijo));
+    TrieNode* mejor_usuario = words ? user.autocomplete(user.find_prefix(prefijo)) : nullptr;
+
+    if (mejor_usuario && (!mejor_base || mejor_usuario->priority >= base_priority(mejor_base))) {
+        return user.get_word(mejor_usuario);
+    }
+    return mejor_base ? base.get_word(mejor_base) : string_view();
+}
+
+/**
+ * @brief Prioridad de la capa si el usuario tocó la palabra; si no, la de la base.
+ * @param w Palabra.
+ */
+uint32_t UserOverlay::priority(string_view w) {
+    TrieNode* v = user.find_prefix(w);
+    if (user.is_terminal(v)) return v->priority;
+    v = base.find_prefix(w);
+    return base.is_terminal(v) ? base_priority(v) : 0;
+}
+
+/**
+ * @brief Prioridad de un terminal de la base en la escala de la capa: con
+ * los mismos reescalados que ya se aplicaron a la capa. Como `rescale` no
+ * invierte comparaciones, el mejor de la base sigue siendo el mejor.
+ * @param v Terminal de la base.
+ */
+uint32_t UserOverlay::base_priority(const TrieNode* v) const {
+    uint32_t p = v->priority;
+    for (uint32_t i = 0; i < rescales && p > 1; ++i) {
+        p = withPolicy(user.variant, [&](auto politica) { return decltype(politica)::rescale(p); });
+    }
+    return p;
+}
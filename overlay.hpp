@@ -0,0 +1,98 @@
+/**
+ * @file overlay.hpp
+ * @brief Personalización por usuario sobre un Trie base compartido.
+ *
+ * Un Trie completo por usuario repite el diccionario y sus prioridades para
+ * cada uno. `UserOverlay` deja el diccionario en un único Trie base, que los
+ * usuarios sólo leen, y guarda por usuario un Trie pequeño con las palabras
+ * que ese usuario usó o agregó. La memoria por usuario crece con lo que
+ * escribió, no con el diccionario.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef OVERLAY_HPP
+#define OVERLAY_HPP
+
+#include <cstdint>
+#include <string_view>
+#include "trie.hpp"
+
+using namespace std;
+
+/**
+ * @brief Capa de un usuario sobre un Trie base que no se modifica.
+ *
+ * La capa guarda, para cada palabra que el usuario tocó, su prioridad
+ * efectiva: la que tenía en la base al primer uso, actualizada después con
+ * la política de la variante (copia al escribir). Como la política sólo
+ * sube prioridades, la prioridad efectiva de una palabra tocada nunca es
+ * menor que la de la base, y la mejor sugerencia de un prefijo es la mayor
+ * entre el mejor terminal de la capa y el de la base bajo ese prefijo: una
+ * palabra de la base que el usuario no tocó tiene a lo más la prioridad del
+ * mejor de la base, y una que tocó compite desde la capa. Una consulta son
+ * dos descensos y una comparación.
+ *
+ * El contador de la capa parte del de la base, así que en RECENT y DECAYED
+ * los usos del usuario cuentan como posteriores a todo lo aprendido en la
+ * base. Varias capas pueden leer la misma base desde hilos distintos
+ * mientras nadie la modifique. Con RECENT y DECAYED la capa se reescala por
+ * su cuenta (ver `Trie::rescale`) sin tocar la base: la capa cuenta sus
+ * reescalados y aplica los mismos a cada prioridad de la base antes de
+ * compararla o copiarla.
+ */
+class UserOverlay {
+public:
+    /**
+     * @brief Crea una capa vacía sobre `base`.
+     * @param base Trie compartido (no se modifica mientras existan capas).
+     */
+    explicit UserOverlay(Trie& base);
+
+    UserOverlay(const UserOverlay&) = delete;
+    UserOverlay& operator=(const UserOverlay&) = delete;
+
+    /**
+     * @brief Registra que el usuario usó la palabra `w` (si no existe en la
+     * base, queda agregada sólo para este usuario).
+     * @param w Palabra usada.
+     */
+    void use(string_view w);
+
+    /**
+     * @brief Mejor sugerencia para el prefijo combinando base y capa.
+     *
+     * Igual que `Trie::autocomplete`, considera sólo palabras más largas que
+     * el prefijo y con prioridad mayor a 0. En empate gana la capa.
+     *
+     * @param prefijo Prefijo escrito.
+     * @return Palabra sugerida (vacía si no hay).
+     */
+    string_view autocomplete(string_view prefijo);
+
+    /**
+     * @brief Prioridad efectiva de la palabra `w` para este usuario.
+     * @param w Palabra.
+     * @return Prioridad (0 si no es una palabra de la base ni de la capa).
+     */
+    uint32_t priority(string_view w);
+
+    /** @brief Palabras guardadas en la capa. */
+    uint32_t user_words() const { return words; }
+
+    /** @brief Memoria ocupada por la capa (la base no se cuenta). */
+    size_t memory_bytes() const { return user.memory_bytes(); }
+
+    /** @brief Trie con las palabras del usuario. */
+    Trie& user_trie() { return user; }
+
+private:
+    Trie& base;        /**< Diccionario compartido */
+    Trie user;         /**< Palabras tocadas por el usuario, con su prioridad efectiva */
+    uint32_t words;    /**< Palabras en `user` */
+    uint32_t rescales; /**< Reescalados de `user` desde que se creó la capa */
+
+    uint32_t base_priority(const TrieNode* v) const;
+};
+
+#endif
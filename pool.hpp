@@ -0,0 +1,351 @@
+/**
+ * @file pool.hpp
+ * @brief Arena de nodos por bloques contiguos con índices de 32 bits.
+ *
+ * `Pool<T>` reserva memoria en bloques cuyo tamaño crece geométricamente
+ * (B, 2B, 4B, ...), de modo que el directorio de bloques tiene tamaño fijo y
+ * los elementos nunca se mueven: un `T*` obtenido del pool sigue siendo válido
+ * mientras el pool exista. Los elementos se referencian con índices `uint32_t`
+ * (el índice 0 se reserva como "nulo") y toda la memoria se libera en bloque
+ * al destruir el pool, sin recorrer los elementos.
+ *
+ * `WordTable` guarda las palabras de los nodos terminales en una arena de
+ * caracteres, evitando un `new string` por palabra.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Arena de elementos `T` con índices de 32 bits.
+ *
+ * El bloque `c` cubre los índices [B(2^c - 1), B(2^(c+1) - 1)), con
+ * B = 2^BASE_LOG, por lo que traducir un índice a dirección cuesta un par de
+ * operaciones de bits y un acceso al directorio.
+ *
+ * @tparam T Tipo almacenado (construible por defecto y con destructor trivial).
+ * @tparam BASE_LOG Logaritmo en base 2 del tamaño del primer bloque.
+ */
+template <typename T, unsigned BASE_LOG = 8>
+class Pool {
+    static_assert(is_trivially_destructible<T>::value,
+                  "Pool libera sus bloques sin llamar destructores");
+public:
+    using value_type = T;
+
+    static constexpr uint32_t NIL = 0;                       /**< Índice nulo */
+    static constexpr unsigned MAX_CHUNKS = 32 - BASE_LOG;    /**< Tamaño del directorio */
+
+    Pool() : chunks{}, count(1) {}
+    ~Pool() { clear(); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    Pool(Pool&& o) noexcept : count(o.count) {
+        memcpy(chunks, o.chunks, sizeof(chunks));
+        memset(o.chunks, 0, sizeof(o.chunks));
+        o.count = 1;
+    }
+
+    Pool& operator=(Pool&& o) noexcept {
+        if (this != &o) {
+            clear();
+            memcpy(chunks, o.chunks, sizeof(chunks));
+            count = o.count;
+            memset(o.chunks, 0, sizeof(o.chunks));
+            o.count = 1;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Reserva un elemento nuevo inicializado por defecto.
+     * @return Índice del elemento.
+     */
+    uint32_t alloc() {
+        uint32_t idx = count;
+        ensure(idx);
+        new (&(*this)[idx]) T();
+        count++;
+        return idx;
+    }
+
+    /**
+     * @brief Reserva `n` elementos contiguos sin inicializar.
+     *
+     * Si el bloque actual no tiene espacio suficiente se salta al siguiente,
+     * dejando un hueco de índices sin usar. El hueco queda en cero, para que
+     * los snapshots (que copian el pool completo) no lleven basura del heap.
+     *
+     * @param n Cantidad de elementos.
+     * @return Índice del primero.
+     */
+    uint32_t alloc_n(uint32_t n) {
+        if (n == 0) return count;
+        while (true) {
+            unsigned c = chunk_of(count);
+            uint64_t end = chunk_start(c + 1);
+            if (count + (uint64_t)n <= end) break;
+            if (c + 1 >= MAX_CHUNKS) throw bad_alloc();
+            if (chunks[c]) memset((void*)&(*this)[count], 0, (size_t)(end - count) * sizeof(T));
+            count = (uint32_t)end;
+        }
+        uint32_t idx = count;
+        ensure(idx);
+        count += n;
+        return idx;
+    }
+
+    /**
+     * @brief Reserva `n` índices consecutivos sin inicializar, aunque crucen
+     * bloques.
+     *
+     * A diferencia de `alloc_n` los elementos no quedan contiguos en memoria
+     * (se acceden por índice), pero tampoco se saltan índices. Una vez
+     * reservados, distintos hilos pueden escribir rangos disjuntos del span
+     * mientras nadie más reserve en el pool.
+     *
+     * @param n Cantidad de elementos.
+     * @return Índice del primero.
+     */
+    uint32_t alloc_span(uint32_t n) {
+        uint32_t idx = count;
+        uint64_t end = (uint64_t)count + n;
+        if (end > UINT32_MAX) throw bad_alloc();
+        for (uint64_t i = idx; i < end; i = chunk_start(chunk_of((uint32_t)i) + 1)) {
+            ensure((uint32_t)i);
+        }
+        count = (uint32_t)end;
+        return idx;
+    }
+
+    /** @brief Acceso por índice. */
+    T& operator[](uint32_t i) {
+        unsigned c = chunk_of(i);
+        return chunks[c][i - chunk_start(c)];
+    }
+
+    /** @brief Acceso por índice (constante). */
+    const T& operator[](uint32_t i) const {
+        unsigned c = chunk_of(i);
+        return chunks[c][i - chunk_start(c)];
+    }
+
+    /**
+     * @brief Cantidad de índices usados (incluye el índice reservado 0).
+     */
+    uint32_t size() const { return count; }
+
+    /**
+     * @brief Bytes ocupados por los elementos en uso.
+     *
+     * Los bloques se reservan sin inicializar, así que la parte no usada del
+     * último bloque no llega a ocupar páginas físicas.
+     */
+    size_t bytes() const { return (size_t)count * sizeof(T); }
+
+    /**
+     * @brief Bytes reservados (virtuales) por los bloques del pool.
+     */
+    size_t reserved_bytes() const {
+        size_t total = 0;
+        for (unsigned c = 0; c < MAX_CHUNKS && chunks[c]; ++c) {
+            total += chunk_size(c) * sizeof(T);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Recorre los índices [0, size()) por tramos contiguos en memoria.
+     *
+     * Un tramo cuyo bloque nunca se reservó (sólo el índice 0 de un pool
+     * vacío) se entrega como `nullptr`.
+     *
+     * @param f Función `f(const T* datos, uint32_t n)`.
+     */
+    template <typename F>
+    void for_each_chunk(F f) const {
+        uint64_t i = 0;
+        for (unsigned c = 0; i < count; ++c) {
+            uint64_t n = min<uint64_t>(chunk_size(c), count - i);
+            f(chunks[c], (uint32_t)n);
+            i += n;
+        }
+    }
+
+    /**
+     * @brief Reemplaza el contenido por `n` elementos contiguos copiados de `data`.
+     *
+     * Inverso de `for_each_chunk`: los índices se conservan, así que no hay
+     * que traducir nada que apunte a estos elementos.
+     *
+     * @param data Elementos de los índices 0..n-1.
+     * @param n Cantidad de índices (incluye el reservado 0).
+     */
+    void assign(const T* data, uint32_t n) {
+        static_assert(is_trivially_copyable<T>::value, "assign copia los elementos con memcpy");
+        clear();
+        uint64_t i = 0;
+        for (unsigned c = 0; i < n; ++c) {
+            uint64_t k = min<uint64_t>(chunk_size(c), n - i);
+            ensure((uint32_t)i);
+            memcpy(chunks[c], data + i, k * sizeof(T));
+            i += k;
+        }
+        count = max<uint32_t>(n, 1);
+    }
+
+    /**
+     * @brief Libera todos los bloques en O(número de bloques).
+     */
+    void clear() {
+        for (unsigned c = 0; c < MAX_CHUNKS; ++c) {
+            ::operator delete(chunks[c]);
+            chunks[c] = nullptr;
+        }
+        count = 1;
+    }
+
+private:
+    T* chunks[MAX_CHUNKS];   /**< Directorio de bloques */
+    uint32_t count;          /**< Próximo índice libre */
+
+    static unsigned chunk_of(uint32_t i) {
+        return 31 - __builtin_clz((i >> BASE_LOG) + 1);
+    }
+
+    static uint64_t chunk_start(unsigned c) {
+        return ((1ULL << c) - 1) << BASE_LOG;
+    }
+
+    static uint64_t chunk_size(unsigned c) {
+        return 1ULL << (c + BASE_LOG);
+    }
+
+    void ensure(uint32_t i) {
+        if (i == UINT32_MAX) throw bad_alloc();
+        unsigned c = chunk_of(i);
+        if (c >= MAX_CHUNKS) throw bad_alloc();
+        if (!chunks[c]) {
+            chunks[c] = static_cast<T*>(::operator new(chunk_size(c) * sizeof(T)));
+            if (c == 0) memset((void*)chunks[0], 0, sizeof(T));  // índice 0 (NIL): nunca se construye
+        }
+    }
+};
+
+/**
+ * @brief Tabla de palabras almacenadas en una arena de caracteres.
+ *
+ * Cada palabra recibe un id denso (desde 1) que guarda su desplazamiento,
+ * largo y el índice del nodo terminal que la representa.
+ */
+class WordTable {
+public:
+    /** @brief Entrada de la tabla. */
+    struct Entry {
+        uint32_t offset;   /**< Posición en la arena de caracteres */
+        uint32_t length;   /**< Largo de la palabra */
+        uint32_t node;     /**< Nodo terminal asociado */
+    };
+
+    /**
+     * @brief Agrega una palabra y devuelve su id.
+     * @param w Palabra.
+     * @param node Índice del nodo terminal.
+     */
+    uint32_t add(string_view w, uint32_t node) {
+        if (w.size() < free_ids.size() && !free_ids[w.size()].empty()) {
+            // reutilizar el id (y los caracteres) de una palabra borrada del mismo largo
+            uint32_t id = free_ids[w.size()].back();
+            free_ids[w.size()].pop_back();
+            Entry& e = entries[id];
+            if (!w.empty()) memcpy(&chars[e.offset], w.data(), w.size());
+            e.node = node;
+            return id;
+        }
+        uint32_t off = chars.alloc_n((uint32_t)w.size());
+        if (!w.empty()) memcpy(&chars[off], w.data(), w.size());
+        uint32_t id = entries.alloc();
+        entries[id] = Entry{off, (uint32_t)w.size(), node};
+        return id;
+    }
+
+    /**
+     * @brief Libera el id de una palabra borrada (su entrada queda con
+     * `node = 0`); `add` lo reutiliza para otra palabra del mismo largo.
+     * @param id Id de la palabra.
+     */
+    void remove(uint32_t id) {
+        Entry& e = entries[id];
+        e.node = 0;
+        if (free_ids.size() <= e.length) free_ids.resize(e.length + 1);
+        free_ids[e.length].push_back(id);
+    }
+
+    /**
+     * @brief Reconstruye las listas de ids libres a partir de las entradas
+     * con `node = 0` (después de cargar los pools).
+     */
+    void rebuild_free() {
+        free_ids.clear();
+        for (uint32_t id = 1; id < entries.size(); ++id) {
+            const Entry& e = entries[id];
+            if (e.node != 0) continue;
+            if (free_ids.size() <= e.length) free_ids.resize(e.length + 1);
+            free_ids[e.length].push_back(id);
+        }
+    }
+
+    /** @brief Palabra asociada al id (vista sin copia). */
+    string_view get(uint32_t id) const {
+        const Entry& e = entries[id];
+        return e.length ? string_view(&chars[e.offset], e.length) : string_view();
+    }
+
+    /**
+     * @brief Puntero a la arena de caracteres (estable mientras exista la tabla).
+     * @param offset Desplazamiento en la arena (ver `Entry::offset`).
+     */
+    const char* data(uint32_t offset) const { return &chars[offset]; }
+
+    /** @brief Entrada asociada al id. */
+    const Entry& entry(uint32_t id) const { return entries[id]; }
+    Entry& entry(uint32_t id) { return entries[id]; }
+
+    /** @brief Cantidad de palabras (ids usados incluyendo el 0). */
+    uint32_t size() const { return entries.size(); }
+
+    /** @brief Bytes ocupados por la tabla. */
+    size_t bytes() const { return entries.bytes() + chars.bytes(); }
+
+    /**
+     * @brief Aplica `f` a cada pool interno, siempre en el mismo orden
+     * (para guardar y cargar snapshots).
+     */
+    template <typename F>
+    void for_each_pool(F f) { f(entries); f(chars); }
+
+    template <typename F>
+    void for_each_pool(F f) const { f(entries); f(chars); }
+
+private:
+    Pool<Entry> entries;      /**< Entradas indexadas por id */
+    Pool<char, 12> chars;     /**< Arena de caracteres */
+    vector<vector<uint32_t>> free_ids;  /**< Ids libres por largo de palabra */
+};
+
+#endif
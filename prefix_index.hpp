@@ -0,0 +1,129 @@
+/**
+ * @file prefix_index.hpp
+ * @brief Tabla hash de prefijos cortos a nodos, para saltar los primeros niveles.
+ *
+ * Casi toda consulta empieza bajando los mismos 2 a 5 niveles desde la raíz,
+ * con un acceso a memoria dependiente por nivel. `PrefixIndex` guarda cada
+ * prefijo de hasta `MAX_LEN` símbolos empaquetado como entero (5 bits por
+ * símbolo) junto al índice de su nodo, así que esos niveles se reemplazan por
+ * un hash y, casi siempre, una sola línea de caché.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef PREFIX_INDEX_HPP
+#define PREFIX_INDEX_HPP
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Tabla hash abierta (sondeo lineal) de clave de prefijo a índice de nodo.
+ *
+ * La clave de un prefijo s_1..s_n es la concatenación de (s_i + 1) en 5 bits,
+ * por lo que nunca es 0 (el 0 marca una celda vacía) y prefijos de distinto
+ * largo no chocan. La capacidad es potencia de 2 y se duplica al pasar de la
+ * mitad de ocupación; borrar no deja marcas, así que la tabla no se degrada
+ * con altas y bajas repetidas.
+ */
+class PrefixIndex {
+public:
+    static constexpr unsigned MAX_LEN = 6;   /**< Símbolos por clave (6 * 5 = 30 bits) */
+
+    PrefixIndex() : used(0), shift(32) {}
+
+    /** @brief Clave del prefijo `clave` extendido con el símbolo `s` (0..26). */
+    static uint32_t extend(uint32_t clave, uint8_t s) { return (clave << 5) | (uint32_t)(s + 1); }
+
+    /**
+     * @brief Nodo de la clave o 0 si no está.
+     */
+    uint32_t find(uint32_t clave) const {
+        if (!used) return 0;
+        uint32_t m = (uint32_t)slots.size() - 1;
+        for (uint32_t i = slot_of(clave);; i = (i + 1) & m) {
+            if (slots[i].key == clave) return slots[i].node;
+            if (slots[i].key == 0) return 0;
+        }
+    }
+
+    /**
+     * @brief Agrega (o reemplaza) la clave con su nodo.
+     */
+    void add(uint32_t clave, uint32_t nodo) {
+        if ((used + 1) * 2 > slots.size()) grow();
+        uint32_t m = (uint32_t)slots.size() - 1;
+        uint32_t i = slot_of(clave);
+        while (slots[i].key != 0 && slots[i].key != clave) i = (i + 1) & m;
+        if (slots[i].key == 0) used++;
+        slots[i] = Slot{clave, nodo};
+    }
+
+    /**
+     * @brief Quita la clave (si está).
+     *
+     * Las claves siguientes del mismo tramo ocupado que ya no serían
+     * alcanzables desde su celda inicial se corren hacia atrás, de modo que
+     * `find` puede seguir deteniéndose en la primera celda vacía.
+     */
+    void erase(uint32_t clave) {
+        if (!used) return;
+        uint32_t m = (uint32_t)slots.size() - 1;
+        uint32_t i = slot_of(clave);
+        while (slots[i].key != clave) {
+            if (slots[i].key == 0) return;
+            i = (i + 1) & m;
+        }
+        for (uint32_t j = (i + 1) & m; slots[j].key != 0; j = (j + 1) & m) {
+            uint32_t k = slot_of(slots[j].key);
+            // la clave de `j` se queda si su celda inicial está en (i, j] (circular)
+            bool queda = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (queda) continue;
+            slots[i] = slots[j];
+            i = j;
+        }
+        slots[i] = Slot{0, 0};
+        used--;
+    }
+
+    /** @brief Vacía la tabla y libera su memoria. */
+    void clear() {
+        vector<Slot>().swap(slots);
+        used = 0;
+        shift = 32;
+    }
+
+    /** @brief Cantidad de prefijos guardados. */
+    size_t size() const { return used; }
+
+    /** @brief Bytes ocupados. */
+    size_t bytes() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t key;    /**< Clave del prefijo (0 = vacía) */
+        uint32_t node;   /**< Índice del nodo */
+    };
+
+    vector<Slot> slots;
+    size_t used;
+    unsigned shift;      /**< 32 - log2(capacidad) */
+
+    /** @brief Celda inicial: hash multiplicativo, bits altos. */
+    uint32_t slot_of(uint32_t clave) const { return (uint32_t)((clave * 0x9E3779B1u) >> shift); }
+
+    void grow() {
+        vector<Slot> viejas;
+        viejas.swap(slots);
+        slots.assign(viejas.empty() ? 64 : viejas.size() * 2, Slot{0, 0});
+        shift = 32 - (unsigned)__builtin_ctz((unsigned)slots.size());
+        used = 0;
+        for (const Slot& s : viejas) {
+            if (s.key) add(s.key, s.node);
+        }
+    }
+};
+
+#endif
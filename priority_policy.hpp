@@ -0,0 +1,206 @@
+/**
+ * @file priority_policy.hpp
+ * @brief Políticas de prioridad del autocompletado (FREQUENCY, RECENT, DECAYED).
+ *
+ * Cada política es un tipo con funciones estáticas que dicen cómo cambia la
+ * prioridad de una palabra al usarla y cómo se combinan dos prioridades de
+ * la misma palabra. Las estructuras guardan la variante como `int` (se elige
+ * en tiempo de ejecución y se guarda en snapshots), pero los caminos
+ * calientes (`update_priority<Policy>`, `recorrer`) reciben la política como
+ * parámetro de plantilla: la variante se consulta una vez con `withPolicy` y
+ * el resto del código se compila sin ramas por variante.
+ *
+ * Para agregar una política: un valor nuevo en `Variant`, un tipo con la
+ * misma interfaz que `FrequencyPolicy` y un caso en `withPolicy`.
+ *
+ * Una política cuyas prioridades crecen con el tiempo (`RecentPolicy`,
+ * `DecayedPolicy`) indica con `needs_rescale` cuándo correrlas todas hacia
+ * abajo; la estructura aplica `rescale` a cada prioridad guardada y
+ * `rescale_counter` a su contador. Es un corrimiento uniforme (sólo las
+ * prioridades más viejas se igualan en 1) y no invierte ninguna comparación,
+ * así que los mejores terminales siguen siendo válidos.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef PRIORITY_POLICY_HPP
+#define PRIORITY_POLICY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Variante de priorización para autocompletado.
+ *
+ * - `FREQUENCY` (0): incrementa contador por cada uso de la palabra.
+ * - `RECENT` (1): asigna prioridades según un contador global para priorizar lo más reciente.
+ * - `DECAYED` (2): frecuencia en la que cada uso pierde la mitad de su peso
+ *   cada `DecayedPolicy::HALF_LIFE` usos.
+ */
+enum Variant { FREQUENCY = 0, RECENT = 1, DECAYED = 2 };
+
+/**
+ * @brief Prioridad = cantidad de usos, saturada en `UINT32_MAX` (con 32 bits
+ * una suma que desborda dejaría a la palabra más usada casi en 0).
+ */
+struct FrequencyPolicy {
+    static constexpr Variant variant = FREQUENCY;
+
+    /**
+     * @brief Prioridad de una palabra después de usarla.
+     * @param prioridad Prioridad actual.
+     * @param contador Contador global de la estructura (no se usa).
+     */
+    static uint32_t bump(uint32_t prioridad, uint32_t& contador) {
+        (void)contador;
+        return prioridad == UINT32_MAX ? prioridad : prioridad + 1;
+    }
+
+    /** @brief Prioridad de una palabra cargada dos veces: los conteos se suman (saturando). */
+    static uint32_t merge(uint32_t a, uint32_t b) { return a > UINT32_MAX - b ? UINT32_MAX : a + b; }
+
+    /** @brief Prioridad multiplicada por `factor` (ver `Trie::decay`). */
+    static uint32_t scale(uint32_t prioridad, double factor) { return (uint32_t)(prioridad * factor); }
+
+    /** @brief Las prioridades no dependen del tiempo: nunca hay que renormalizar. */
+    static bool needs_rescale(uint32_t contador) { (void)contador; return false; }
+    static uint32_t rescale(uint32_t prioridad) { return prioridad; }
+    static uint32_t rescale_counter(uint32_t contador) { return contador; }
+};
+
+/**
+ * @brief Prioridad = momento del último uso (contador global creciente).
+ *
+ * El contador es de 32 bits: al llegar a `LIMIT` usos la estructura corre
+ * contador y prioridades `SHIFT` hacia atrás. El orden de los usos se
+ * conserva salvo entre palabras no usadas en los últimos `SHIFT` usos, que
+ * quedan empatadas en 1 (siguen por encima de las nunca usadas).
+ */
+struct RecentPolicy {
+    static constexpr Variant variant = RECENT;
+    static constexpr uint32_t LIMIT = 1u << 31;   /**< Contador desde el que se renormaliza */
+    static constexpr uint32_t SHIFT = 1u << 30;   /**< Corrimiento de cada renormalización */
+
+    /**
+     * @brief Prioridad de una palabra después de usarla.
+     * @param prioridad Prioridad actual (no se usa).
+     * @param contador Contador global; avanza en uno.
+     */
+    static uint32_t bump(uint32_t prioridad, uint32_t& contador) {
+        (void)prioridad;
+        return contador++;
+    }
+
+    /** @brief Prioridad de una palabra cargada dos veces: gana el uso más reciente. */
+    static uint32_t merge(uint32_t a, uint32_t b) { return max(a, b); }
+
+    /** @brief Prioridad multiplicada por `factor` (conserva el orden de los usos). */
+    static uint32_t scale(uint32_t prioridad, double factor) { return (uint32_t)(prioridad * factor); }
+
+    /** @brief True si el contador llegó a `LIMIT` (lejos aún de desbordar 32 bits). */
+    static bool needs_rescale(uint32_t contador) { return contador >= LIMIT; }
+
+    /** @brief Prioridad corrida `SHIFT` usos hacia atrás (los usos más viejos quedan en 1). */
+    static uint32_t rescale(uint32_t prioridad) {
+        return prioridad > SHIFT ? prioridad - SHIFT : (prioridad ? 1 : 0);
+    }
+
+    /** @brief Contador corrido igual que las prioridades. */
+    static uint32_t rescale_counter(uint32_t contador) { return contador - SHIFT; }
+};
+
+/**
+ * @brief Prioridad = frecuencia con decaimiento exponencial, guardada en
+ * forma logarítmica y escalada hacia adelante.
+ *
+ * El puntaje de una palabra en el instante `ahora` es la suma de
+ * 2^-((ahora - t_i) / HALF_LIFE) sobre sus usos t_i (el contador global).
+ * Como el factor 2^-(ahora / HALF_LIFE) es común a todas las palabras, para
+ * comparar basta S = suma de 2^(t_i / HALF_LIFE), que no cambia con el
+ * tiempo: una palabra que no se usa no hay que tocarla. S crece
+ * exponencialmente, así que se guarda 1 + log2(S) en punto fijo (`SCALE`
+ * unidades por duplicación); un uso es una suma logarítmica en O(1) y el
+ * resto del Trie sigue comparando enteros como en FREQUENCY. El 0 sigue
+ * significando "sin usos".
+ *
+ * El término de un uso nuevo avanza `STEP` unidades por uso. Antes de
+ * desbordar (2^31 unidades, unos 537 millones de usos) la estructura corre
+ * todas las prioridades `SHIFT` unidades hacia abajo en una pasada O(n); las
+ * palabras que quedan por debajo pesan menos de 2^-4096 que el último uso y
+ * se igualan en 1.
+ */
+struct DecayedPolicy {
+    static constexpr Variant variant = DECAYED;
+    static constexpr uint32_t STEP = 4;                   /**< Unidades por uso */
+    static constexpr uint32_t HALF_LIFE = 1u << 16;       /**< Usos en que un uso pierde la mitad de su peso */
+    static constexpr uint32_t SCALE = STEP * HALF_LIFE;   /**< Unidades por duplicación del puntaje */
+    static constexpr uint32_t LIMIT = 1u << 31;           /**< Término desde el que se renormaliza */
+    static constexpr uint32_t SHIFT = 1u << 30;           /**< Corrimiento de cada renormalización */
+
+    /**
+     * @brief Prioridad de una palabra después de usarla.
+     * @param prioridad Prioridad actual (forma logarítmica).
+     * @param contador Contador global (el instante del uso); avanza en uno.
+     */
+    static uint32_t bump(uint32_t prioridad, uint32_t& contador) {
+        uint32_t termino = 1 + (uint32_t)((uint64_t)contador++ * STEP);
+        return merge(prioridad, termino);
+    }
+
+    /**
+     * @brief Suma logarítmica: prioridad de la suma de ambos puntajes.
+     *
+     * 1 + log2(Sa + Sb) = mayor + log2(1 + 2^-(diferencia)); con una
+     * diferencia de más de 32 duplicaciones el menor no alcanza a sumar una
+     * unidad.
+     */
+    static uint32_t merge(uint32_t a, uint32_t b) {
+        if (!a || !b) return a | b;
+        uint32_t mayor = max(a, b), dif = mayor - min(a, b);
+        if (dif >= 32 * SCALE) return mayor;
+        return mayor + (uint32_t)lround(SCALE * log2(1.0 + exp2(-(double)dif / SCALE)));
+    }
+
+    /**
+     * @brief Puntaje multiplicado por `factor`: en forma logarítmica es
+     * restar log2(1 / factor) duplicaciones (sin bajar de 1 a un puntaje con usos).
+     */
+    static uint32_t scale(uint32_t prioridad, double factor) {
+        if (!prioridad || factor <= 0) return 0;
+        double resta = -log2(factor) * SCALE;
+        return resta < prioridad ? prioridad - (uint32_t)lround(resta) : 1;
+    }
+
+    /** @brief True si el próximo uso se acerca al desborde. */
+    static bool needs_rescale(uint32_t contador) { return (uint64_t)contador * STEP >= LIMIT; }
+
+    /** @brief Prioridad corrida `SHIFT` unidades hacia abajo (los usos viejos quedan en 1). */
+    static uint32_t rescale(uint32_t prioridad) {
+        return prioridad > SHIFT ? prioridad - SHIFT : (prioridad ? 1 : 0);
+    }
+
+    /** @brief Contador corrido el equivalente a `SHIFT` unidades. */
+    static uint32_t rescale_counter(uint32_t contador) { return contador - SHIFT / STEP; }
+};
+
+/**
+ * @brief Llama a `f` con la política de la variante `variant`.
+ *
+ * `f` recibe un valor de la política (un tipo vacío); dentro se usa como
+ * `decltype(p)`. Una variante desconocida se trata como FREQUENCY.
+ *
+ * @param variant Variante (`Variant`).
+ * @param f Función genérica `f(politica)`.
+ * @return Lo que devuelve `f`.
+ */
+template <typename F>
+inline auto withPolicy(int variant, F&& f) {
+    if (variant == RECENT) return f(RecentPolicy{});
+    if (variant == DECAYED) return f(DecayedPolicy{});
+    return f(FrequencyPolicy{});
+}
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file radix_trie.cpp
+ * @brief Implementación del Trie con compresión de caminos (radix/Patricia).
+ *
+ * Las etiquetas de las aristas apuntan a la arena de caracteres de la tabla
+ * de palabras, así que partir una arista sólo ajusta desplazamientos. Las
+ * comparaciones de caracteres usan `charToIndex`, igual que `Trie`, para que
+ * ambas estructuras reconozcan exactamente los mismos prefijos.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#include "radix_trie.hpp"
+#include "utils.hpp"
+
+/**
+ * @brief Constructor por defecto de un nodo del Trie comprimido.
+ *
+ * Inicializa índices y prioridades en 0 y deja la etiqueta vacía.
+ */
+RadixNode::RadixNode():
+    parent(0),
+    best_terminal(0),
+    word(0),
+    priority(0),
+    best_priority(0),
+    edge_best(0),
+    edge_priority(0),
+    label(0),
+    children{0, KIND_NONE, 0},
+    label_len(0),
+    is_terminal(false) {}
+
+/**
+ * @brief Constructor del Trie comprimido.
+ *
+ * @param variant_mode Modo de prioridad para el autocompletado (FREQUENCY, RECENT o DECAYED).
+ */
+RadixTrie::RadixTrie(int variant_mode) {
+    variant = variant_mode;
+    root = nodes.alloc();
+    global_counter = 1;
+    size = 1;
+    propagation_steps = 0;
+}
+
+/**
+ * @brief Parte la arista que llega a `child` después de `keep` caracteres.
+ *
+ * Crea un nodo intermedio con la primera parte de la etiqueta, que hereda el
+ * mejor terminal del subárbol de `child`.
+ *
+ * @param parent Índice del padre actual de `child`.
+ * @param child Índice del nodo cuya arista se parte.
+ * @param keep Caracteres de la etiqueta que quedan sobre el nodo intermedio.
+ * @return Índice del nodo intermedio.
+ */
+uint32_t RadixTrie::split(uint32_t parent, uint32_t child, uint32_t keep) {
+    uint32_t mid = nodes.alloc();
+    RadixNode& c = nodes[child];
+    RadixNode& m = nodes[mid];
+
+    m.parent = parent;
+    m.label = c.label;
+    m.label_len = keep;
+    children.replace(nodes[parent].children, charToIndex(words.data(c.label)[0]), mid);
+
+    c.label += keep;
+    c.label_len -= keep;
+    c.parent = mid;
+    children.add(m.children, charToIndex(words.data(c.label)[0]), child);
+
+    // el subárbol del nodo intermedio es el de `child` (incluyéndolo)
+    m.best_terminal = m.edge_best = c.edge_best;
+    m.best_priority = m.edge_priority = c.edge_priority;
+
+    size++;
+    return mid;
+}
+
+/**
+ * @brief Inserta una palabra en el Trie comprimido.
+ *
+ * Baja por las aristas mientras la etiqueta coincida; si la palabra diverge
+ * a mitad de una arista la parte, y el resto de la palabra se cuelga como una
+ * sola hoja.
+ *
+ * @param w Palabra a insertar.
+ * @return Nodo terminal de la palabra.
+ */
+RadixNode* RadixTrie::insert(string_view w) {
+    uint32_t current = root;
+    size_t i = 0;
+
+    while (i < w.size()) {
+        uint8_t key = charToIndex(w[i]);
+        uint32_t child = children.find(nodes[current].children, key);
+
+        if (child == 0) {
+            // el resto de la palabra se vuelve una hoja
+            uint32_t leaf = nodes.alloc();
+            uint32_t id = words.add(w, leaf);
+            RadixNode& l = nodes[leaf];
+            l.parent = current;
+            l.word = id;
+            l.is_terminal = true;
+            l.label = words.entry(id).offset + (uint32_t)i;
+            l.label_len = (uint32_t)(w.size() - i);
+            children.add(nodes[current].children, key, leaf);
+            size++;
+            return &l;
+        }
+
+        const RadixNode& c = nodes[child];
+        const char* label = words.data(c.label);
+        uint32_t m = 1;  // el primer carácter coincide por construcción
+        while (m < c.label_len && i + m < w.size() &&
+               charToIndex(label[m]) == charToIndex(w[i + m])) {
+            m++;
+        }
+
+        if (m < c.label_len) {
+            child = split(current, child, m);
+        }
+        current = child;
+        i += m;
+    }
+
+    RadixNode* node = &nodes[current];
+    if (!node->is_terminal) {
+        node->is_terminal = true;
+        node->word = words.add(w, current);
+        node->priority = 0;
+    }
+    return node;
+}
+
+/**
+ * @brief Avanza un carácter, ya sea dentro de la etiqueta o hacia un hijo.
+ *
+ * @param p Posición de partida.
+ * @param c Caracter a seguir.
+ * @return Nueva posición, o una posición nula si el prefijo no existe.
+ */
+RadixPos RadixTrie::descend(RadixPos p, const char c) {
+    if (!p.node) return p;
+    uint8_t key = charToIndex(c);
+
+    if (p.off < p.node->label_len) {
+        if (charToIndex(words.data(p.node->label)[p.off]) == key) {
+            return RadixPos{p.node, p.off + 1};
+        }
+        return RadixPos{nullptr, 0};
+    }
+
+    uint32_t child = children.find(p.node->children, key);
+    return child ? RadixPos{&nodes[child], 1} : RadixPos{nullptr, 0};
+}
+
+/**
+ * @brief Devuelve el terminal con mayor prioridad bajo la posición `p`.
+ *
+ * En un nodo se usa `best_terminal` igual que en `Trie`; a mitad de arista se
+ * usa `edge_best`, donde el propio nodo de abajo también compite.
+ *
+ * @param p Posición desde la cual se consulta.
+ * @return Nodo terminal con mayor prioridad, o `nullptr`.
+ */
+RadixNode* RadixTrie::autocomplete(RadixPos p) {
+    RadixNode* v = p.node;
+    if (!v) return nullptr;
+    uint32_t best = (p.off < v->label_len) ? v->edge_best : v->best_terminal;
+    return best ? &nodes[best] : nullptr;
+}
+
+/**
+ * @brief Actualiza la prioridad de un nodo terminal y propaga la mejor opción hacia la raíz.
+ *
+ * Igual que en `Trie`, elige la política según la variante y delega en
+ * `update_priority<Policy>`.
+ *
+ * @param v Nodo terminal cuya prioridad se debe actualizar.
+ */
+void RadixTrie::update_priority(RadixNode* v) {
+    withPolicy(variant, [&](auto p) { update_priority<decltype(p)>(v); });
+}
+
+/**
+ * @brief Corre todas las prioridades con `rescale` de la política (ver
+ * `Trie::rescale`).
+ */
+void RadixTrie::rescale() {
+    withPolicy(variant, [&](auto p) {
+        using Policy = decltype(p);
+        for (uint32_t i = 1; i < nodes.size(); ++i) {
+            RadixNode& n = nodes[i];
+            n.priority = Policy::rescale(n.priority);
+            n.best_priority = Policy::rescale(n.best_priority);
+            n.edge_priority = Policy::rescale(n.edge_priority);
+        }
+        global_counter = Policy::rescale_counter(global_counter);
+    });
+}
+
+/**
+ * @brief Propaga la prioridad nueva del terminal `v` hacia la raíz.
+ *
+ * Misma lógica que `Trie::propagate`, pero cada paso sube una arista
+ * completa en vez de un carácter. En cada nodo se mantienen ambos mejores
+ * (sin y con el propio nodo) y se sigue subiendo mientras alguno cambie.
+ *
+ * @param v Nodo terminal cuya prioridad acaba de cambiar.
+ */
+void RadixTrie::propagate(RadixNode* v) {
+    uint32_t self = words.entry(v->word).node;
+    if (v->edge_priority < v->priority) {
+        v->edge_priority = v->priority;
+        v->edge_best = self;
+    }
+
+    uint32_t node = v->parent;
+    while (node != 0) {
+        RadixNode& n = nodes[node];
+        propagation_steps++;
+        bool changed = false;
+        if (n.best_priority < v->priority) {
+            n.best_priority = v->priority;
+            n.best_terminal = self;
+            changed = true;
+        }
+        if (n.edge_priority < v->priority) {
+            n.edge_priority = v->priority;
+            n.edge_best = self;
+            changed = true;
+        }
+        if (!changed) break;  // ya no se necesita subir más
+        node = n.parent;
+    }
+}
+
+/**
+ * @brief Devuelve la cantidad de nodos del Trie comprimido.
+ * @return Número de nodos (incluye la raíz).
+ */
+int RadixTrie::get_size() const {
+    return size;
+}
+
+/**
+ * @brief Devuelve la memoria ocupada por el Trie comprimido.
+ * @return Cantidad de bytes ocupados.
+ */
+size_t RadixTrie::memory_bytes() const {
+    return nodes.bytes() + children.bytes() + words.bytes();
+}
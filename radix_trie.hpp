@@ -0,0 +1,209 @@
+/**
+ * @file radix_trie.hpp
+ * @brief Declaraciones del Trie con compresión de caminos (radix/Patricia).
+ *
+ * Las cadenas de nodos con un solo hijo se colapsan en una arista etiquetada,
+ * de modo que la cantidad de nodos depende del número de palabras y no del
+ * total de caracteres. Como una posición puede quedar a mitad de una arista,
+ * la navegación usa `RadixPos` en vez de un puntero a nodo, manteniendo la
+ * misma interfaz por carácter que `Trie` (`descend`, `autocomplete`,
+ * `update_priority`).
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef RADIX_TRIE_HPP
+#define RADIX_TRIE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "pool.hpp"
+#include "children.hpp"
+#include "priority_policy.hpp"
+
+using namespace std;
+
+/**
+ * @brief Nodo del Trie comprimido.
+ *
+ * La etiqueta de la arista que llega al nodo se guarda como un trozo de la
+ * arena de caracteres de la tabla de palabras (no se copia). Además del mejor
+ * terminal bajo el nodo se guarda el mejor incluyendo al propio nodo, que es
+ * lo que tendrían los nodos colapsados de la arista en un `Trie` normal.
+ */
+struct RadixNode {
+    uint32_t parent;                     /**< Índice del padre */
+    uint32_t best_terminal;              /**< Índice del mejor terminal bajo el nodo */
+    uint32_t word;                       /**< Id de la palabra en nodos terminales (0 si no hay) */
+    uint32_t priority;                   /**< Prioridad del nodo (para autocompletar) */
+    uint32_t best_priority;              /**< Prioridad del `best_terminal` */
+    uint32_t edge_best;                  /**< Mejor terminal incluyendo al propio nodo (a mitad de arista) */
+    uint32_t edge_priority;              /**< Prioridad de `edge_best` */
+    uint32_t label;                      /**< Desplazamiento de la etiqueta en la arena */
+    ChildRef children;                   /**< Hijos indexados por el primer carácter de su etiqueta */
+    uint32_t label_len;                  /**< Largo de la etiqueta de la arista entrante */
+    bool is_terminal;                    /**< True si el nodo marca el fin de una palabra */
+
+    /**
+     * @brief Constructor por defecto inicializa los campos.
+     */
+    RadixNode();
+};
+
+/**
+ * @brief Posición dentro del Trie comprimido.
+ *
+ * `node` es el nodo al final de la arista actual y `off` cuántos caracteres
+ * de su etiqueta ya se consumieron; si `off == node->label_len` la posición
+ * está exactamente en el nodo. Una posición con `node == nullptr` indica que
+ * el prefijo no existe.
+ */
+struct RadixPos {
+    RadixNode* node;   /**< Nodo al final de la arista */
+    uint32_t off;      /**< Caracteres consumidos de la etiqueta */
+
+    explicit operator bool() const { return node != nullptr; }
+};
+
+/**
+ * @brief Trie con compresión de caminos para autocompletado.
+ *
+ * Soporta las mismas variantes de prioridad que `Trie` (FREQUENCY, RECENT y DECAYED).
+ */
+class RadixTrie {
+    public:
+    /**
+     * @brief Construye un Trie comprimido vacío.
+     * @param variant_mode Variante de autocompletado: 0 = FREQUENCY, 1 = RECENT, 2 = DECAYED
+     */
+    RadixTrie(int variant_mode);
+
+    RadixTrie(const RadixTrie&) = delete;
+    RadixTrie& operator=(const RadixTrie&) = delete;
+
+    int variant; /**< Variante activa del autocompletado (FREQUENCY/RECENT/DECAYED) */
+
+    /**
+     * @brief Inserta la palabra `w`, partiendo aristas si es necesario.
+     * @param w Palabra a insertar.
+     * @return Nodo terminal de la palabra.
+     */
+    RadixNode* insert(string_view w);
+
+    /**
+     * @brief Avanza un carácter desde la posición `p`.
+     * @param p Posición de partida.
+     * @param c Carácter a seguir.
+     * @return Nueva posición (nula si no existe la rama).
+     */
+    RadixPos descend(RadixPos p, const char c);
+
+    /**
+     * @brief Obtiene la mejor sugerencia para el prefijo representado por `p`.
+     *
+     * A mitad de arista el prefijo todavía no llega a `p.node`, por lo que
+     * el propio nodo también es candidato.
+     *
+     * @param p Posición desde la cual se consulta.
+     * @return Nodo terminal con mayor prioridad o `nullptr`.
+     */
+    RadixNode* autocomplete(RadixPos p);
+
+    /**
+     * @brief Actualiza la prioridad del nodo terminal `v` y propaga cambios.
+     * @param v Nodo terminal cuya prioridad se actualiza.
+     */
+    void update_priority(RadixNode* v);
+
+    /**
+     * @brief Igual que `update_priority(RadixNode*)` para una posición terminal.
+     * @param p Posición (debe estar exactamente en un nodo terminal).
+     */
+    void update_priority(RadixPos p) { if (is_terminal(p)) update_priority(p.node); }
+
+    /**
+     * @brief Igual que `update_priority(RadixNode*)` con la política fijada en
+     * compilación (debe coincidir con `variant`).
+     * @tparam Policy `FrequencyPolicy`, `RecentPolicy`, ...
+     * @param v Nodo terminal cuya prioridad se actualiza.
+     */
+    template <class Policy>
+    void update_priority(RadixNode* v) {
+        if (!v || !v->is_terminal) return;  // seguridad
+        v->priority = Policy::bump(v->priority, global_counter);
+        propagate(v);
+        if (Policy::needs_rescale(global_counter)) rescale();
+    }
+
+    /**
+     * @brief Igual que `update_priority<Policy>(RadixNode*)` para una posición terminal.
+     * @param p Posición (debe estar exactamente en un nodo terminal).
+     */
+    template <class Policy>
+    void update_priority(RadixPos p) { if (is_terminal(p)) update_priority<Policy>(p.node); }
+
+    /**
+     * @brief Indica si la posición corresponde a una palabra completa.
+     * @param p Posición a consultar.
+     */
+    bool is_terminal(RadixPos p) const {
+        return p.node && p.off == p.node->label_len && p.node->is_terminal;
+    }
+
+    /**
+     * @brief Devuelve la posición de la raíz.
+     */
+    RadixPos get_root() { return RadixPos{&nodes[root], 0}; }
+
+    /**
+     * @brief Devuelve la palabra almacenada en un nodo terminal.
+     * @param v Nodo a consultar.
+     * @return Palabra o cadena vacía si `v` no es terminal.
+     */
+    string get_str(const RadixNode* v) const { return string(get_word(v)); }
+
+    /**
+     * @brief Igual que `get_str` pero sin copiar la palabra.
+     * @param v Nodo a consultar.
+     */
+    string_view get_word(const RadixNode* v) const {
+        return (v && v->word) ? words.get(v->word) : string_view();
+    }
+
+    /**
+     * @brief Devuelve el número de nodos (incluye la raíz).
+     */
+    int get_size() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por nodos, hijos y palabras.
+     * @return Cantidad de bytes.
+     */
+    size_t memory_bytes() const;
+
+    /**
+     * @brief Cantidad total de ancestros visitados por `update_priority`.
+     */
+    uint64_t get_propagation_steps() const { return propagation_steps; }
+private:
+    Pool<RadixNode> nodes;     /**< Arena de nodos (índice 0 reservado) */
+    ChildStore children;       /**< Bloques de hijos de los nodos */
+    WordTable words;           /**< Palabras y etiquetas de las aristas */
+
+    uint32_t root;             /**< Índice de la raíz */
+
+    uint32_t global_counter;   /**< Contador usado por RECENT y DECAYED */
+
+    uint64_t size; // tamaño
+
+    uint64_t propagation_steps; /**< Pasos de propagación acumulados */
+
+    uint32_t split(uint32_t parent, uint32_t child, uint32_t keep);
+
+    void propagate(RadixNode* v);
+
+    void rescale();
+};
+
+#endif
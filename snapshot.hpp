@@ -0,0 +1,241 @@
+/**
+ * @file snapshot.hpp
+ * @brief Formato binario para guardar y cargar pools completos.
+ *
+ * Un snapshot es una cabecera seguida de secciones, una por pool, alineadas
+ * a 64 bytes. Cada sección es la imagen de los índices [0, size()) del pool
+ * tal cual están en memoria. Como las estructuras se enlazan por índices de
+ * 32 bits y no por punteros, la imagen es independiente de la posición: al
+ * cargar basta mapear el archivo y copiar cada sección a su pool con un
+ * `memcpy` por bloque, sin traducir nada.
+ *
+ * Un checksum de 64 bits cubre las secciones y la cabecera, y la cabecera
+ * guarda la versión del formato y el tamaño de cada tipo, de modo que un
+ * archivo truncado, corrupto o de otra versión se rechaza al cargar.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tokenizer.hpp"
+
+using namespace std;
+
+/**
+ * @brief Ubicación de una sección dentro del archivo.
+ */
+struct SnapshotSection {
+    uint64_t offset;      /**< Desplazamiento desde el inicio del archivo */
+    uint64_t count;       /**< Cantidad de elementos (índices del pool) */
+    uint64_t elem_size;   /**< `sizeof` del elemento al guardar */
+};
+
+/**
+ * @brief Checksum de 64 bits por palabras de 8 bytes, acumulable por partes.
+ *
+ * No es criptográfico: detecta archivos truncados o corruptos a varios GB/s.
+ * El resultado no depende de cómo se dividan los datos entre llamadas.
+ */
+class Checksum {
+public:
+    /** @brief Agrega `len` bytes. */
+    void update(const void* data, size_t len) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        while (len > 0 && pending_len > 0) {
+            add_byte(*p++);
+            len--;
+        }
+        for (; len >= 8; p += 8, len -= 8) {
+            uint64_t w;
+            memcpy(&w, p, 8);
+            mix(w);
+        }
+        while (len-- > 0) add_byte(*p++);
+    }
+
+    /** @brief Valor final (incluye los bytes pendientes y el largo total). */
+    uint64_t digest() const {
+        uint64_t h = hash;
+        if (pending_len) h = (h ^ pending) * PRIMO;
+        h ^= total;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+private:
+    static constexpr uint64_t PRIMO = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint64_t pending = 0;
+    unsigned pending_len = 0;
+    uint64_t total = 0;
+
+    void mix(uint64_t w) {
+        hash = (hash ^ w) * PRIMO;
+        total += 8;
+    }
+
+    void add_byte(unsigned char b) {
+        pending |= (uint64_t)b << (8 * pending_len);
+        if (++pending_len == 8) {
+            mix(pending);
+            pending = 0;
+            pending_len = 0;
+        }
+    }
+};
+
+/**
+ * @brief Escribe un snapshot: reserva la cabecera, agrega secciones y al
+ * final escribe la cabecera con el checksum.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Crea el archivo. Lanza `runtime_error` si no se puede abrir.
+     * @param ruta Ruta del archivo.
+     * @param header_bytes Tamaño de la cabecera que se escribirá con `finish`.
+     */
+    SnapshotWriter(const string& ruta, size_t header_bytes) : archivo(ruta, ios::binary | ios::trunc), path(ruta) {
+        if (!archivo.is_open()) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        pos = 0;
+        zeros(header_bytes);
+    }
+
+    /**
+     * @brief Agrega un pool completo como sección.
+     * @param pool Pool (o cualquier tipo con `for_each_chunk` y `size`).
+     * @return Ubicación de la sección, para guardarla en la cabecera.
+     */
+    template <typename P>
+    SnapshotSection write(const P& pool) {
+        using T = typename P::value_type;
+        zeros((64 - pos % 64) % 64);
+        SnapshotSection s{pos, pool.size(), sizeof(T)};
+        pool.for_each_chunk([&](const T* datos, uint32_t n) {
+            size_t bytes = (size_t)n * sizeof(T);
+            if (datos) {
+                put(datos, bytes);
+                sum.update(datos, bytes);
+            } else {
+                vector<char> cero(bytes, 0);
+                put(cero.data(), bytes);
+                sum.update(cero.data(), bytes);
+            }
+        });
+        return s;
+    }
+
+    /**
+     * @brief Escribe la cabecera al inicio y cierra el archivo.
+     * @param header Cabecera (su checksum ya debe incluir `checksum()`).
+     * @param bytes Tamaño de la cabecera.
+     */
+    void finish(const void* header, size_t bytes) {
+        archivo.seekp(0);
+        archivo.write(static_cast<const char*>(header), (streamsize)bytes);
+        archivo.close();
+        if (archivo.fail()) {
+            throw runtime_error("No se pudo escribir el archivo: " + path);
+        }
+    }
+
+    /** @brief Checksum de las secciones escritas. */
+    const Checksum& checksum() const { return sum; }
+
+private:
+    ofstream archivo;
+    string path;
+    uint64_t pos;
+    Checksum sum;
+
+    void put(const void* data, size_t n) {
+        archivo.write(static_cast<const char*>(data), (streamsize)n);
+        pos += n;
+    }
+
+    void zeros(size_t n) {
+        static const char cero[256] = {};
+        while (n > 0) {
+            size_t k = min(n, sizeof(cero));
+            put(cero, k);
+            n -= k;
+        }
+    }
+};
+
+/**
+ * @brief Lee un snapshot mapeando el archivo completo.
+ */
+class SnapshotReader {
+public:
+    /**
+     * @brief Mapea el archivo. Lanza `runtime_error` si no se puede abrir.
+     * @param ruta Ruta del archivo.
+     */
+    explicit SnapshotReader(const string& ruta) : archivo(ruta), path(ruta) {
+        archivo.prefetch(0, archivo.size());
+        base = archivo.map(0, archivo.size());
+    }
+
+    /** @brief Tamaño del archivo. */
+    uint64_t size() const { return archivo.size(); }
+
+    /**
+     * @brief Copia la cabecera (verificando que el archivo la contenga).
+     * @param header Destino.
+     * @param bytes Tamaño de la cabecera.
+     */
+    void header(void* header, size_t bytes) const {
+        if (size() < bytes) fail("archivo truncado");
+        memcpy(header, base, bytes);
+    }
+
+    /**
+     * @brief Verifica que la sección quepa en el archivo, sea del tipo
+     * esperado y la acumula en el checksum.
+     */
+    template <typename P>
+    void check(const SnapshotSection& s, Checksum& sum) const {
+        using T = typename P::value_type;
+        if (s.elem_size != sizeof(T)) fail("tamaño de elemento distinto");
+        if (s.count == 0 || s.count > UINT32_MAX || s.offset % 64 != 0 || s.offset > size() ||
+            s.count * sizeof(T) > size() - s.offset) {
+            fail("sección fuera del archivo");
+        }
+        sum.update(base + s.offset, (size_t)(s.count * sizeof(T)));
+    }
+
+    /**
+     * @brief Copia una sección (ya verificada) a su pool.
+     */
+    template <typename P>
+    void read(P& pool, const SnapshotSection& s) const {
+        using T = typename P::value_type;
+        pool.assign(reinterpret_cast<const T*>(base + s.offset), (uint32_t)s.count);
+    }
+
+    /** @brief Lanza el error de snapshot inválido. */
+    [[noreturn]] void fail(const string& motivo) const {
+        throw runtime_error("Snapshot inválido (" + motivo + "): " + path);
+    }
+
+private:
+    MappedFile archivo;
+    string path;
+    const char* base;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file successors.hpp
+ * @brief Tablas de sucesores por palabra, para predecir la palabra siguiente.
+ *
+ * Cada palabra (por su id de `WordTable`) puede tener un bloque de tamaño
+ * fijo con las palabras que más veces la siguieron. Un conteo exacto de
+ * bigramas crece con el vocabulario al cuadrado; con bloques de `capacity`
+ * entradas la memoria por palabra queda acotada y la predicción es leer la
+ * primera entrada del bloque.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef SUCCESSORS_HPP
+#define SUCCESSORS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "pool.hpp"
+
+using namespace std;
+
+/**
+ * @brief Sucesor de una palabra y cuántas veces se observó (estimado).
+ */
+struct SuccessorEntry {
+    uint32_t word;    /**< Id de la palabra siguiente (0 = entrada vacía) */
+    uint32_t count;   /**< Conteo estimado */
+};
+
+/**
+ * @brief Bloques de sucesores indexados por id de palabra.
+ *
+ * Cada bloque se mantiene con el algoritmo Space-Saving: un sucesor nuevo
+ * con el bloque lleno reemplaza a la última entrada (la de menor conteo) y
+ * hereda su conteo más uno. Así los sucesores frecuentes no se pierden por
+ * llegar tarde, y el conteo de cada entrada sobreestima el real a lo más en
+ * el mínimo del bloque. Las entradas quedan ordenadas por conteo
+ * descendente, de modo que la mejor predicción es la primera.
+ */
+class SuccessorTable {
+public:
+    SuccessorTable() : cap(0), used(0) {}
+
+    /**
+     * @brief Borra todas las tablas y fija la capacidad de cada bloque.
+     * @param capacidad Entradas por palabra (0 = desactivadas).
+     */
+    void reset(uint32_t capacidad) {
+        heads.clear();
+        slots.clear();
+        cap = capacidad;
+        used = 0;
+    }
+
+    /** @brief Entradas por bloque (0 = desactivadas). */
+    uint32_t capacity() const { return cap; }
+
+    /** @brief Palabras con bloque de sucesores. */
+    uint32_t tables() const { return used; }
+
+    /**
+     * @brief Bloque de sucesores de la palabra `id` (`capacity()` entradas) o
+     * `nullptr` si no tiene.
+     */
+    const SuccessorEntry* find(uint32_t id) const {
+        if (id >= heads.size() || !heads[id]) return nullptr;
+        return &slots[heads[id]];
+    }
+
+    /**
+     * @brief Registra que la palabra `siguiente` apareció después de `id`.
+     * @param id Id de la palabra anterior.
+     * @param siguiente Id de la palabra siguiente.
+     */
+    void observe(uint32_t id, uint32_t siguiente) {
+        if (!cap || !id || !siguiente) return;
+        while (heads.size() <= id) heads.alloc();
+        if (!heads[id]) {
+            heads[id] = slots.alloc_n(cap);
+            memset(&slots[heads[id]], 0, cap * sizeof(SuccessorEntry));
+            used++;
+        }
+        SuccessorEntry* e = &slots[heads[id]];
+
+        uint32_t i = 0;
+        while (i < cap && e[i].word != siguiente && e[i].word != 0) i++;
+        if (i == cap) {
+            // bloque lleno: se reemplaza la entrada de menor conteo
+            i = cap - 1;
+            e[i].word = siguiente;
+        } else if (e[i].word == 0) {
+            e[i].word = siguiente;
+        }
+        if (e[i].count != UINT32_MAX) e[i].count++;
+        for (; i > 0 && e[i - 1].count < e[i].count; --i) swap(e[i - 1], e[i]);
+    }
+
+    /**
+     * @brief Olvida las palabras borradas antes de que sus ids se reutilicen:
+     * vacía sus bloques (que quedan reservados para el id) y las quita de los
+     * bloques que las nombran, corriendo las entradas siguientes para
+     * conservar el orden. Una pasada por todos los bloques.
+     * @param borrada Predicado `borrada(id)`.
+     */
+    template <typename F>
+    void forget_if(F borrada) {
+        if (!cap) return;
+        for (uint32_t h = 1; h < heads.size(); ++h) {
+            if (!heads[h]) continue;
+            SuccessorEntry* e = &slots[heads[h]];
+            if (borrada(h)) {
+                memset(e, 0, cap * sizeof(SuccessorEntry));
+                continue;
+            }
+            uint32_t j = 0;
+            for (uint32_t i = 0; i < cap && e[i].word != 0; ++i) {
+                if (!borrada(e[i].word)) e[j++] = e[i];
+            }
+            for (; j < cap && e[j].word != 0; ++j) e[j] = SuccessorEntry{0, 0};
+        }
+    }
+
+    /** @brief Bytes ocupados por las tablas. */
+    size_t bytes() const { return heads.bytes() + slots.bytes(); }
+
+    /**
+     * @brief Aplica `f` a cada pool interno, siempre en el mismo orden
+     * (para guardar y cargar snapshots).
+     */
+    template <typename F>
+    void for_each_pool(F f) { f(heads); f(slots); }
+
+    template <typename F>
+    void for_each_pool(F f) const { f(heads); f(slots); }
+
+    /**
+     * @brief Fija la capacidad y recuenta los bloques después de cargar los pools.
+     * @param capacidad Entradas por bloque con que se guardaron.
+     */
+    void restore(uint32_t capacidad) {
+        cap = capacidad;
+        used = 0;
+        for (uint32_t id = 1; id < heads.size(); ++id) used += heads[id] != 0;
+    }
+
+private:
+    Pool<uint32_t, 10> heads;          /**< Bloque de cada id de palabra (0 = sin bloque) */
+    Pool<SuccessorEntry, 10> slots;    /**< Bloques contiguos de `cap` entradas */
+    uint32_t cap;                      /**< Entradas por bloque */
+    uint32_t used;                     /**< Bloques reservados */
+};
+
+#endif
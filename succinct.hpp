@@ -0,0 +1,182 @@
+/**
+ * @file succinct.hpp
+ * @brief Vectores de bits con rank/select y arreglos de enteros empaquetados.
+ *
+ * Son las piezas de las representaciones compactas de sólo lectura (ver
+ * `LoudsTrie`). Se construyen una vez agregando bits al final y después no
+ * cambian, así que los directorios de rank y select se arman al cerrar.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef SUCCINCT_HPP
+#define SUCCINCT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Vector de bits inmutable con `rank1` en O(1) y `select0` en O(log n).
+ *
+ * Directorio de rank: un contador de 32 bits cada 512 bits (8 palabras), es
+ * decir un 6,25% extra. Para `select0` se guarda además, cada 512 ceros, el
+ * bloque donde cae ese cero, lo que acota la búsqueda binaria a unos pocos
+ * bloques.
+ */
+class BitVector {
+public:
+    /** @brief Agrega un bit al final (sólo antes de `seal`). */
+    void push_back(bool b) {
+        if (n % 64 == 0) bits.push_back(0);
+        if (b) bits.back() |= 1ULL << (n % 64);
+        n++;
+    }
+
+    /** @brief Arma los directorios de rank y select. */
+    void seal() {
+        bits.push_back(0);  // centinela: las lecturas de la palabra siguiente son válidas
+        blocks.assign(bits.size() / 8 + 2, 0);
+        uint32_t unos = 0;
+        for (size_t w = 0; w < bits.size(); ++w) {
+            if (w % 8 == 0) blocks[w / 8] = unos;
+            unos += (uint32_t)__builtin_popcountll(bits[w]);
+        }
+        for (size_t b = (bits.size() + 7) / 8; b < blocks.size(); ++b) blocks[b] = unos;
+
+        // muestra j: bloque que contiene al cero 512*j + 1
+        zero_samples.clear();
+        for (size_t b = 0; b + 1 < blocks.size(); ++b) {
+            uint64_t hasta = zeros_before(b + 1);
+            while ((uint64_t)zero_samples.size() * 512 + 1 <= hasta) zero_samples.push_back((uint32_t)b);
+        }
+        zero_samples.push_back((uint32_t)(blocks.size() - 1));
+    }
+
+    /** @brief Bit en la posición `i`. */
+    bool operator[](uint64_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+
+    /** @brief Cantidad de unos en [0, i). */
+    uint64_t rank1(uint64_t i) const {
+        uint64_t w = i / 64;
+        uint64_t r = blocks[w / 8];
+        for (uint64_t k = w & ~7ULL; k < w; ++k) r += __builtin_popcountll(bits[k]);
+        if (i % 64) r += __builtin_popcountll(bits[w] & ((1ULL << (i % 64)) - 1));
+        return r;
+    }
+
+    /**
+     * @brief Posición del k-ésimo cero (k >= 1).
+     */
+    uint64_t select0(uint64_t k) const {
+        // bloque: el último cuyo conteo de ceros previos es < k
+        uint64_t lo = zero_samples[(k - 1) / 512];
+        uint64_t hi = zero_samples[min<uint64_t>((k - 1) / 512 + 1, zero_samples.size() - 1)] + 1;
+        while (hi - lo > 1) {
+            uint64_t mid = (lo + hi) / 2;
+            if (zeros_before(mid) < k) lo = mid;
+            else hi = mid;
+        }
+        uint64_t resto = k - zeros_before(lo);
+        for (uint64_t w = lo * 8;; ++w) {
+            uint64_t ceros = ~bits[w];
+            uint64_t c = (uint64_t)__builtin_popcountll(ceros);
+            if (resto <= c) return w * 64 + select_in_word(ceros, resto);
+            resto -= c;
+        }
+    }
+
+    /**
+     * @brief Posición del primer cero en `i` o después.
+     */
+    uint64_t next0(uint64_t i) const {
+        uint64_t w = i / 64;
+        uint64_t ceros = ~bits[w] & (~0ULL << (i % 64));
+        while (ceros == 0) ceros = ~bits[++w];
+        return w * 64 + __builtin_ctzll(ceros);
+    }
+
+    /** @brief Cantidad de bits. */
+    uint64_t size() const { return n; }
+
+    /** @brief Bytes de los bits más los directorios. */
+    size_t bytes() const {
+        return bits.size() * sizeof(uint64_t) + blocks.size() * sizeof(uint32_t) +
+               zero_samples.size() * sizeof(uint32_t);
+    }
+
+private:
+    vector<uint64_t> bits;          /**< Bits, 64 por palabra */
+    vector<uint32_t> blocks;        /**< Unos antes de cada bloque de 512 bits */
+    vector<uint32_t> zero_samples;  /**< Bloque del cero 512*j + 1, para cada j */
+    uint64_t n = 0;
+
+    /** @brief Ceros (incluido el relleno final) antes del bloque `b`. */
+    uint64_t zeros_before(uint64_t b) const { return b * 512 - blocks[b]; }
+
+    /** @brief Posición del r-ésimo bit en 1 (r >= 1) dentro de `w`. */
+    static unsigned select_in_word(uint64_t w, uint64_t r) {
+        while (--r) w &= w - 1;
+        return (unsigned)__builtin_ctzll(w);
+    }
+};
+
+/**
+ * @brief Arreglo de enteros de `width` bits cada uno, contiguos en memoria.
+ */
+class PackedArray {
+public:
+    PackedArray() : width(1) {}
+
+    /**
+     * @brief Crea `n` ceros de `w` bits (1 <= w <= 32).
+     */
+    PackedArray(uint64_t n, unsigned w) : words((n * w + 63) / 64 + 1, 0), width(w), count(n) {}
+
+    /** @brief Bits necesarios para guardar valores hasta `maximo`. */
+    static unsigned bits_for(uint64_t maximo) {
+        return maximo ? 64 - __builtin_clzll(maximo) : 1;
+    }
+
+    /** @brief Valor en la posición `i`. */
+    uint32_t get(uint64_t i) const {
+        uint64_t bit = i * width;
+        uint64_t w = bit / 64;
+        unsigned off = bit % 64;
+        uint64_t v = words[w] >> off;
+        if (off + width > 64) v |= words[w + 1] << (64 - off);
+        return (uint32_t)(v & mask());
+    }
+
+    /** @brief Escribe `v` en la posición `i`. */
+    void set(uint64_t i, uint32_t v) {
+        uint64_t bit = i * width;
+        uint64_t w = bit / 64;
+        unsigned off = bit % 64;
+        words[w] = (words[w] & ~(mask() << off)) | ((uint64_t)v << off);
+        if (off + width > 64) {
+            unsigned alto = 64 - off;
+            words[w + 1] = (words[w + 1] & ~(mask() >> alto)) | ((uint64_t)v >> alto);
+        }
+    }
+
+    /** @brief Cantidad de elementos. */
+    uint64_t size() const { return count; }
+
+    /** @brief Bits por elemento. */
+    unsigned bits() const { return width; }
+
+    /** @brief Bytes ocupados. */
+    size_t bytes() const { return words.size() * sizeof(uint64_t); }
+
+private:
+    vector<uint64_t> words;
+    unsigned width;
+    uint64_t count = 0;
+
+    uint64_t mask() const { return (1ULL << width) - 1; }
+};
+
+#endif
@@ -0,0 +1,422 @@
+/**
+ * @file tokenizer.hpp
+ * @brief Lectura de datasets con el archivo mapeado en memoria, sin copias.
+ *
+ * `Tokenizer` recorre el archivo por ventanas mapeadas (`mmap` en POSIX,
+ * `MapViewOfFile` en Windows) y entrega cada palabra como un `string_view`
+ * que apunta directamente a la ventana, así que no hay una reserva de memoria
+ * por palabra. Mientras se procesa una ventana se le pide al sistema operativo
+ * que lea por adelantado la siguiente, de modo que archivos más grandes que la
+ * RAM se recorren con memoria acotada al tamaño de la ventana.
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Indica si `c` separa palabras (mismo criterio que `operator>>`).
+ */
+inline bool esSeparador(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Archivo de solo lectura mapeado por ventanas.
+ *
+ * Sólo una ventana está mapeada a la vez; `map` libera la anterior.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Abre el archivo. Lanza `runtime_error` si no se puede abrir.
+     * @param ruta Ruta del archivo.
+     */
+    explicit MappedFile(const string& ruta) {
+#ifdef _WIN32
+        file = CreateFileA(ruta.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        LARGE_INTEGER sz;
+        GetFileSizeEx(file, &sz);
+        file_size = (uint64_t)sz.QuadPart;
+        mapping = file_size ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        granularity = info.dwAllocationGranularity;
+#else
+        fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        struct stat st;
+        fstat(fd, &st);
+        file_size = (uint64_t)st.st_size;
+        granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    ~MappedFile() {
+        unmap();
+#ifdef _WIN32
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Mapea la ventana [offset, offset + length) del archivo.
+     * @param offset Inicio (múltiplo de `get_granularity()`).
+     * @param length Largo (se recorta al final del archivo).
+     * @return Puntero al inicio de la ventana (o `nullptr` si está vacía).
+     */
+    const char* map(uint64_t offset, uint64_t length) {
+        unmap();
+        if (offset >= file_size) return nullptr;
+        if (offset + length > file_size) length = file_size - offset;
+#ifdef _WIN32
+        view = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(offset >> 32),
+                             (DWORD)(offset & 0xFFFFFFFF), (SIZE_T)length);
+        if (!view) throw runtime_error("No se pudo mapear el archivo");
+#else
+        view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (view == MAP_FAILED) {
+            view = nullptr;
+            throw runtime_error("No se pudo mapear el archivo");
+        }
+        madvise(view, length, MADV_SEQUENTIAL);
+#endif
+        view_len = length;
+        return static_cast<const char*>(view);
+    }
+
+    /**
+     * @brief Pide al sistema operativo leer por adelantado un rango del archivo.
+     * @param offset Inicio del rango.
+     * @param length Largo del rango.
+     */
+    void prefetch(uint64_t offset, uint64_t length) {
+        if (offset >= file_size) return;
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fd, (off_t)offset, (off_t)length, POSIX_FADV_WILLNEED);
+#else
+        (void)length;
+#endif
+    }
+
+    /** @brief Tamaño del archivo en bytes. */
+    uint64_t size() const { return file_size; }
+
+    /** @brief Alineación requerida para el desplazamiento de una ventana. */
+    uint64_t get_granularity() const { return granularity; }
+
+private:
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    void* view = nullptr;
+    uint64_t view_len = 0;
+    uint64_t file_size = 0;
+    uint64_t granularity = 4096;
+
+    void unmap() {
+        if (!view) return;
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+#else
+        munmap(view, view_len);
+#endif
+        view = nullptr;
+    }
+};
+
+/**
+ * @brief Normaliza un byte: minúscula si es letra ASCII, sin cambios si no es
+ * ASCII (bytes de UTF-8) y espacio para todo lo demás (espacios, puntuación,
+ * dígitos y controles).
+ */
+inline char normalizarByte(char c) {
+    unsigned char u = (unsigned char)c;
+    if (u >= 'A' && u <= 'Z') return (char)(u + 32);
+    if ((u >= 'a' && u <= 'z') || u >= 0x80) return c;
+    return ' ';
+}
+
+/**
+ * @brief Versión escalar de `normalizarBloque`.
+ * @param in Bytes de entrada.
+ * @param out Salida (puede ser igual a `in`).
+ * @param n Cantidad de bytes.
+ */
+inline void normalizarEscalar(const char* in, char* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = normalizarByte(in[i]);
+}
+
+#ifdef __SSE2__
+/**
+ * @brief Normaliza 16 bytes por iteración con SSE2.
+ *
+ * Los rangos 'A'..'Z' y 'a'..'z' se detectan desplazando cada byte para que
+ * el rango quede al inicio de los enteros con signo y comparando una sola vez.
+ */
+inline void normalizarSSE2(const char* in, char* out, size_t n) {
+    const __m128i despl_may = _mm_set1_epi8((char)(0x80 - 'A'));
+    const __m128i despl_min = _mm_set1_epi8((char)(0x80 - 'a'));
+    const __m128i limite = _mm_set1_epi8((char)(0x80 + 26));
+    const __m128i bit_min = _mm_set1_epi8(0x20);
+    const __m128i espacios = _mm_set1_epi8(' ');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i may = _mm_cmplt_epi8(_mm_add_epi8(x, despl_may), limite);
+        __m128i min = _mm_cmplt_epi8(_mm_add_epi8(x, despl_min), limite);
+        __m128i alto = _mm_cmplt_epi8(x, _mm_setzero_si128());
+        __m128i letra = _mm_or_si128(_mm_or_si128(may, min), alto);
+        __m128i bajada = _mm_add_epi8(x, _mm_and_si128(may, bit_min));
+        __m128i res = _mm_or_si128(_mm_and_si128(letra, bajada), _mm_andnot_si128(letra, espacios));
+        _mm_storeu_si128((__m128i*)(out + i), res);
+    }
+    normalizarEscalar(in + i, out + i, n - i);
+}
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKENIZER_AVX2 1
+#include <immintrin.h>
+
+/**
+ * @brief Igual que `normalizarSSE2` pero con 32 bytes por iteración (AVX2).
+ *
+ * Se compila con el atributo `target` para no exigir `-mavx2` a todo el
+ * programa; sólo se llama si la CPU lo soporta.
+ */
+__attribute__((target("avx2")))
+inline void normalizarAVX2(const char* in, char* out, size_t n) {
+    const __m256i despl_may = _mm256_set1_epi8((char)(0x80 - 'A'));
+    const __m256i despl_min = _mm256_set1_epi8((char)(0x80 - 'a'));
+    const __m256i limite = _mm256_set1_epi8((char)(0x80 + 26));
+    const __m256i bit_min = _mm256_set1_epi8(0x20);
+    const __m256i espacios = _mm256_set1_epi8(' ');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i may = _mm256_cmpgt_epi8(limite, _mm256_add_epi8(x, despl_may));
+        __m256i min = _mm256_cmpgt_epi8(limite, _mm256_add_epi8(x, despl_min));
+        __m256i alto = _mm256_cmpgt_epi8(_mm256_setzero_si256(), x);
+        __m256i letra = _mm256_or_si256(_mm256_or_si256(may, min), alto);
+        __m256i bajada = _mm256_add_epi8(x, _mm256_and_si256(may, bit_min));
+        __m256i res = _mm256_blendv_epi8(espacios, bajada, letra);
+        _mm256_storeu_si256((__m256i*)(out + i), res);
+    }
+    normalizarEscalar(in + i, out + i, n - i);
+}
+#endif
+
+/**
+ * @brief Pasa a minúsculas y reemplaza separadores y puntuación por espacios.
+ *
+ * Elige en tiempo de ejecución AVX2, SSE2 o la versión escalar.
+ *
+ * @param in Bytes de entrada.
+ * @param out Salida (puede ser igual a `in`).
+ * @param n Cantidad de bytes.
+ */
+inline void normalizarBloque(const char* in, char* out, size_t n) {
+#ifdef TOKENIZER_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+        normalizarAVX2(in, out, n);
+        return;
+    }
+#endif
+#ifdef __SSE2__
+    normalizarSSE2(in, out, n);
+#else
+    normalizarEscalar(in, out, n);
+#endif
+}
+
+/**
+ * @brief Busca desde `i` el primer byte que sea (o no sea) un espacio.
+ *
+ * Sobre texto normalizado el único separador es ' ', así que la búsqueda se
+ * hace comparando 16 bytes a la vez.
+ *
+ * @param p Buffer normalizado.
+ * @param i Posición inicial.
+ * @param n Largo del buffer.
+ * @param espacio true para buscar un espacio, false para buscar otro byte.
+ * @return Posición encontrada o `n`.
+ */
+inline size_t buscarEspacio(const char* p, size_t i, size_t n, bool espacio) {
+#ifdef __SSE2__
+    const __m128i espacios = _mm_set1_epi8(' ');
+    for (; i + 16 <= n; i += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + i)), espacios));
+        if (!espacio) m = ~m & 0xFFFF;
+        if (m) return i + __builtin_ctz(m);
+    }
+#endif
+    while (i < n && (p[i] == ' ') != espacio) i++;
+    return i;
+}
+
+/**
+ * @brief Separa un archivo en palabras sin copiarlas.
+ *
+ * Los `string_view` entregados son válidos hasta la siguiente llamada a
+ * `next`. Una palabra que cruza el borde entre dos ventanas se arma en un
+ * buffer interno que se reutiliza, así que tampoco reserva memoria por palabra.
+ *
+ * Con `normalizar = true` cada ventana se procesa por bloques con
+ * `normalizarBloque` (minúsculas y puntuación como separador) antes de
+ * separar palabras, de modo que "The", "the," y "the" llegan al Trie como la
+ * misma palabra. En ese caso las vistas apuntan al bloque normalizado.
+ */
+class Tokenizer {
+public:
+    /**
+     * @brief Abre el archivo a recorrer.
+     * @param ruta Ruta del archivo.
+     * @param normalizar true para pasar a minúsculas y separar por puntuación.
+     * @param ventana Tamaño de cada ventana mapeada (se alinea a la granularidad).
+     */
+    explicit Tokenizer(const string& ruta, bool normalizar = false, uint64_t ventana = 64ULL << 20)
+        : file(ruta), normalize(normalizar) {
+        uint64_t g = file.get_granularity();
+        window = max<uint64_t>(g, (ventana + g - 1) / g * g);
+        if (normalize) norm.resize((size_t)min<uint64_t>(window, BLOQUE));
+        load(0);
+    }
+
+    /**
+     * @brief Entrega la siguiente palabra.
+     * @param palabra Salida: vista a la palabra.
+     * @return false si no quedan palabras.
+     */
+    bool next(string_view& palabra) {
+        while (true) {
+            pos = skip(pos);
+            if (pos < len) break;
+            if (!load(base + len)) return false;
+        }
+
+        size_t inicio = pos;
+        pos = word_end(pos);
+        if (pos < len || base + len >= file.size()) {
+            palabra = string_view(data + inicio, pos - inicio);
+            return true;
+        }
+
+        // la palabra continúa en el bloque siguiente
+        carry.assign(data + inicio, pos - inicio);
+        while (load(base + len)) {
+            pos = word_end(0);
+            carry.append(data, pos);
+            if (pos < len) break;
+        }
+        palabra = carry;
+        return true;
+    }
+
+    /** @brief Bytes del archivo ya recorridos. */
+    uint64_t bytes_read() const { return base + pos; }
+
+    /** @brief Tamaño total del archivo. */
+    uint64_t size() const { return file.size(); }
+
+private:
+    static constexpr uint64_t BLOQUE = 256 << 10;   /**< Bloque normalizado de una vez */
+
+    MappedFile file;
+    bool normalize;            /**< Normalizar mayúsculas y puntuación */
+    uint64_t window;           /**< Tamaño de ventana */
+    uint64_t wbase = 0;        /**< Desplazamiento de la ventana mapeada */
+    const char* wdata = nullptr;
+    size_t wlen = 0;           /**< Largo de la ventana mapeada */
+    vector<char> norm;         /**< Bloque normalizado */
+    uint64_t base = 0;         /**< Desplazamiento del bloque actual */
+    const char* data = nullptr;
+    size_t len = 0;            /**< Largo del bloque actual */
+    size_t pos = 0;            /**< Posición dentro del bloque */
+    string carry;              /**< Palabra que cruza bloques */
+
+    size_t skip(size_t i) const {
+        if (normalize) return buscarEspacio(data, i, len, false);
+        while (i < len && esSeparador(data[i])) i++;
+        return i;
+    }
+
+    size_t word_end(size_t i) const {
+        if (normalize) return buscarEspacio(data, i, len, true);
+        while (i < len && !esSeparador(data[i])) i++;
+        return i;
+    }
+
+    bool load(uint64_t offset) {
+        if (offset >= file.size()) {
+            base = file.size();
+            data = nullptr;
+            len = pos = 0;
+            return false;
+        }
+        if (offset < wbase || offset >= wbase + wlen) {
+            wdata = file.map(offset, window);
+            wbase = offset;
+            wlen = (size_t)min<uint64_t>(window, file.size() - offset);
+            file.prefetch(offset + window, window);
+        }
+
+        size_t rel = (size_t)(offset - wbase);
+        if (normalize) {
+            len = min(norm.size(), wlen - rel);
+            normalizarBloque(wdata + rel, norm.data(), len);
+            data = norm.data();
+        } else {
+            data = wdata + rel;
+            len = wlen - rel;
+        }
+        base = offset;
+        pos = 0;
+        return true;
+    }
+};
+
+#endif // TOKENIZER_HPP
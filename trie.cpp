@@ -3,76 +3,477 @@
  * @brief Implementación de la estructura Trie (árbol de prefijos) y sus operaciones.
  *
  * Este archivo contiene la implementación de los métodos declarados en
- * `trie.hpp`. El Trie soporta dos variantes de prioridad para autocompletado:
- * FREQUENCY (incrementa contador por cada uso) y RECENT (prioriza por uso reciente).
+ * `trie.hpp`. El Trie soporta tres variantes de prioridad para autocompletado:
+ * FREQUENCY (incrementa contador por cada uso), RECENT (prioriza por uso
+ * reciente) y DECAYED (conteo con decaimiento exponencial).
  *
  * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
  */
 
 #include "trie.hpp"
 #include "utils.hpp" 
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 
 /**
  * @brief Constructor por defecto de un nodo del Trie.
  *
- * Inicializa punteros a `nullptr`, marca `is_terminal` como false y pone
- * prioridades en 0. El arreglo `next` se rellena con `nullptr`.
+ * Inicializa los índices en 0 (nulo), marca `is_terminal` como false y pone
+ * prioridades en 0. El nodo parte sin bloque de hijos.
  */
 TrieNode::TrieNode():
-    parent(nullptr),
-    is_terminal(false),
-    str(nullptr),
+    parent(0),
+    best_terminal(0),
+    word(0),
     priority(0),
-    best_terminal(nullptr),
-    best_priority(0) {
-        next.fill(nullptr);
-    }
+    best_priority(0),
+    topk(0),
+    children{0, KIND_NONE, 0, 0},
+    is_terminal(false),
+    spare{} {}
 
 /**
  * @brief Constructor del Trie.
  *
- * @param variant_mode Modo de prioridad para el autocompletado (FREQUENCY o RECENT).
+ * @param variant_mode Modo de prioridad para el autocompletado (FREQUENCY, RECENT o DECAYED).
+ * @param layout_mode Layout de los hijos (FIXED_LAYOUT o ADAPTIVE_LAYOUT).
  *
  * Inicializa la raíz y variables internas como `global_counter` y `size`.
  */
-Trie::Trie(int variant_mode) {
-    root = new TrieNode();
-    root->parent = nullptr;
-    root->best_terminal = nullptr;
-    root->best_priority = 0;
-    global_counter = 1;
+Trie::Trie(int variant_mode, int layout_mode) {
     variant = variant_mode;           // FREQUENCY por defecto
+    layout = layout_mode;
+    global_counter = 1;
+    free_nodes = 0;
+    free_topk = 0;
+    root = new_node(0);
     size = 1;
+    propagation_steps = 0;
+    topk_k = 0;
+    topk_max_depth = 0;
+    jump_len = 0;
+    lazy_recent = false;
+}
+
+/**
+ * @brief Crea un nodo hijo de `parent` en el pool.
+ *
+ * Reutiliza primero los nodos liberados por `remove`. Con `FIXED_LAYOUT` el
+ * nodo recibe de inmediato su bloque de 27 hijos, igual que el arreglo `next`
+ * original.
+ *
+ * @param parent Índice del padre (0 para la raíz).
+ * @return Índice del nodo creado.
+ */
+uint32_t Trie::new_node(uint32_t parent) {
+    uint32_t idx;
+    if (free_nodes) {
+        idx = free_nodes;
+        free_nodes = nodes[idx].word;
+        nodes[idx] = TrieNode();
+    } else {
+        idx = nodes.alloc();
+    }
+    nodes[idx].parent = parent;
+    if (layout == FIXED_LAYOUT) {
+        children.make_full(nodes[idx].children);
+    }
+    return idx;
 }
 
 /**
  * @brief Inserta una palabra en el Trie.
  *
- * Si parte del camino no existe, crea nodos nuevos. Marca el nodo terminal
- * correspondiente y guarda la cadena (alloca un `string`).
+ * Si parte del camino no existe, crea nodos nuevos en el pool. Marca el nodo
+ * terminal correspondiente y guarda la palabra en la tabla de palabras.
  *
- * @param w Referencia a la palabra a insertar.
+ * @param w Palabra a insertar.
+ * @return Nodo terminal de la palabra.
  */
-void Trie::insert(const string& w){
-    TrieNode* current = root;
+TrieNode* Trie::insert(string_view w){
+    uint32_t current = root;
+    uint32_t clave = 0;
 
-    for (char c : w) {
-        int index = charToIndex(c);
+    for (size_t d = 0; d < w.size(); ++d) {
+        uint8_t index = charToIndex(w[d]);
+        uint32_t child = children.find(nodes[current].children, index);
         // crear nodos de ser necesario
-        if (current->next[index] == nullptr) {
-            current->next[index] = new TrieNode();
-            current->next[index]->parent = current;
+        if (child == 0) {
+            child = new_node(current);
+            children.add(nodes[current].children, index, child);
             size++;
+            if (d < jump_len) jumps.add(PrefixIndex::extend(clave, index), child);
         }
+        if (d < jump_len) clave = PrefixIndex::extend(clave, index);
+
+        current = child;
+    }
+
+    TrieNode* node = &nodes[current];
+    if (!node->is_terminal) {
+        // la palabra queda lista antes de que un lector vea el nodo como terminal;
+        // un nodo borrado en modo concurrente conserva su id
+        node->priority = 0;
+        if (!node->word) __atomic_store_n(&node->word, words.add(w, current), __ATOMIC_RELEASE);
+        __atomic_store_n(&node->is_terminal, true, __ATOMIC_RELEASE);
+    }
+    children.collect();
+    return node;
+}
+
+/**
+ * @brief Inserta un conjunto de palabras y calcula los mejores terminales al final.
+ *
+ * Se mantiene el camino de la palabra anterior: para cada palabra se retrocede
+ * hasta el largo del prefijo común y sólo se crean los nodos que faltan. Con
+ * entrada ordenada cada nodo se crea justo después de su padre y de sus
+ * hermanos menores, así que el pool queda en preorden.
+ *
+ * Si una palabra se repite sus prioridades se combinan con la política
+ * (`merge`): en FREQUENCY se suman (son conteos) y en RECENT se conserva la
+ * mayor. Para
+ * RECENT el contador global queda por encima de toda prioridad cargada, de
+ * modo que los usos posteriores sigan siendo los más recientes.
+ *
+ * @param palabras Palabras a insertar.
+ * @param prioridades Prioridad inicial de cada palabra (vacío = todas en 0).
+ */
+void Trie::build_sorted(const vector<string_view>& palabras, const vector<uint32_t>& prioridades) {
+    if (!prioridades.empty() && prioridades.size() != palabras.size()) {
+        throw runtime_error("build_sorted: se esperaban " + to_string(palabras.size()) + " prioridades");
+    }
+
+    vector<uint32_t> camino{root};   // camino[d] = nodo del prefijo de largo d
+    string_view anterior;
+
+    for (size_t i = 0; i < palabras.size(); ++i) {
+        string_view w = palabras[i];
+
+        size_t comun = 0;
+        size_t limite = min(w.size(), anterior.size());
+        while (comun < limite && charToIndex(w[comun]) == charToIndex(anterior[comun])) comun++;
+        camino.resize(comun + 1);
+
+        uint32_t current = camino.back();
+        for (size_t d = comun; d < w.size(); ++d) {
+            uint8_t index = charToIndex(w[d]);
+            uint32_t child = children.find(nodes[current].children, index);
+            if (child == 0) {
+                child = new_node(current);
+                children.add(nodes[current].children, index, child);
+                size++;
+            }
+            current = child;
+            camino.push_back(current);
+        }
+        anterior = w;
+
+        TrieNode& node = nodes[current];
+        if (!node.is_terminal) {
+            node.is_terminal = true;
+            if (!node.word) node.word = words.add(w, current);
+            node.priority = 0;
+        }
+        if (!prioridades.empty()) {
+            node.priority = withPolicy(variant, [&](auto p) { return decltype(p)::merge(node.priority, prioridades[i]); });
+            if (variant == RECENT && node.priority >= global_counter) global_counter = node.priority + 1;
+        }
+    }
+
+    rebuild_best();
+    if (topk_k) enable_topk(topk_k, topk_max_depth);
+    if (jump_len) enable_jump_table(jump_len);
+}
+
+/**
+ * @brief Recalcula `best_terminal` y `best_priority` de todos los nodos.
+ *
+ * Normalmente todo nodo está en el pool después de su padre, así que
+ * recorrer el pool de atrás hacia adelante procesa cada subárbol antes que su
+ * raíz: una pasada O(n). Los nodos libres (padre 0) se saltan: no son
+ * terminales y no tienen a quién subir. Si un nodo reutilizado quedó antes
+ * que su padre, el orden se toma de un preorden desde la raíz, recorrido al
+ * revés. En empates gana el terminal de menor índice.
+ */
+void Trie::rebuild_best() {
+    bool en_orden = true;
+    for (uint32_t i = 1; i < nodes.size(); ++i) {
+        nodes[i].best_terminal = 0;
+        nodes[i].best_priority = 0;
+        en_orden &= nodes[i].parent < i;
+    }
+
+    auto subir = [&](uint32_t i) {
+        const TrieNode& n = nodes[i];
+        if (!n.parent) return;  // nodo libre: el índice 0 no es un nodo
+        uint32_t best = n.best_terminal, prio = n.best_priority;
+        if (n.is_terminal && n.priority > 0 && n.priority >= prio) {
+            best = i;
+            prio = n.priority;
+        }
+        offer_best(nodes[n.parent], best, prio);
+    };
+
+    if (en_orden) {
+        for (uint32_t i = nodes.size() - 1; i > root; --i) subir(i);
+        return;
+    }
+
+    vector<uint32_t> orden;
+    orden.reserve(size);
+    vector<uint32_t> pila{root};
+    while (!pila.empty()) {
+        uint32_t n = pila.back();
+        pila.pop_back();
+        orden.push_back(n);
+        children.for_each(nodes[n].children, [&](uint8_t, uint32_t c) { pila.push_back(c); });
+    }
+    for (size_t j = orden.size() - 1; j > 0; --j) subir(orden[j]);
+}
+
+/**
+ * @brief Propone `candidate` como mejor terminal de `n`; en empates gana el
+ * de menor índice.
+ *
+ * @param n Nodo a actualizar.
+ * @param candidate Índice del terminal propuesto.
+ * @param prio Prioridad del terminal propuesto.
+ */
+void Trie::offer_best(TrieNode& n, uint32_t candidate, uint32_t prio) const {
+    if (prio > n.best_priority || (prio > 0 && prio == n.best_priority && candidate < n.best_terminal)) {
+        n.best_priority = prio;
+        n.best_terminal = candidate;
+    }
+}
+
+/**
+ * @brief Construye el Trie en paralelo a partir de Tries parciales.
+ *
+ * 1. Cada palabra pertenece a una unidad según sus dos primeros caracteres
+ *    (27 x 28, el segundo puede ser el fin de palabra). Las unidades se
+ *    asignan a los hilos de mayor a menor cantidad de palabras, siempre al
+ *    hilo con menos carga, así que ninguna letra inicial frecuente queda
+ *    sola en un hilo.
+ * 2. Cada hilo filtra sus palabras (conservando el orden de entrada) y arma
+ *    un Trie propio con `build_sorted`: pools, hijos y palabras separados, sin
+ *    locks.
+ * 3. Se reservan rangos de índices para cada Trie parcial y cada hilo copia
+ *    sus nodos y bloques de hijos desplazando índices, mientras el hilo
+ *    principal copia las palabras.
+ * 4. Como dos hilos pueden compartir la primera letra, los nodos de
+ *    profundidad 1 repetidos se fusionan con el primero (quedan como nodos
+ *    vacíos sin padre que los referencie) y se recalculan los mejores
+ *    terminales de esos nodos y de la raíz.
+ *
+ * @param palabras Palabras a insertar.
+ * @param prioridades Prioridad inicial de cada palabra (vacío = todas en 0).
+ * @param hilos Cantidad de hilos (0 = los que tenga la máquina).
+ */
+void Trie::build_parallel(const vector<string_view>& palabras, const vector<uint32_t>& prioridades,
+                          unsigned hilos) {
+    if (hilos == 0) hilos = max(1u, thread::hardware_concurrency());
+    if (hilos == 1 || size > 1 || palabras.size() < hilos) {
+        build_sorted(palabras, prioridades);
+        return;
+    }
+    if (!prioridades.empty() && prioridades.size() != palabras.size()) {
+        throw runtime_error("build_sorted: se esperaban " + to_string(palabras.size()) + " prioridades");
+    }
+
+    // 1. reparto de unidades (dos primeros caracteres) entre hilos
+    const int UNIDADES = 27 * 28;
+    auto unidad = [](string_view w) {
+        if (w.empty()) return 0;  // no se reparte (ver el final)
+        return charToIndex(w[0]) * 28 + (w.size() > 1 ? charToIndex(w[1]) + 1 : 0);
+    };
+    vector<uint64_t> conteo(UNIDADES, 0);
+    for (string_view w : palabras) conteo[unidad(w)]++;
+
+    vector<int> orden(UNIDADES);
+    for (int u = 0; u < UNIDADES; ++u) orden[u] = u;
+    stable_sort(orden.begin(), orden.end(), [&](int a, int b) { return conteo[a] > conteo[b]; });
+    vector<uint64_t> carga(hilos, 0);
+    vector<uint8_t> dueno(UNIDADES, 0);
+    for (int u : orden) {
+        unsigned h = (unsigned)(min_element(carga.begin(), carga.end()) - carga.begin());
+        dueno[u] = (uint8_t)h;
+        carga[h] += conteo[u];
+    }
+
+    // 2. Tries parciales en paralelo
+    vector<unique_ptr<Trie>> partes(hilos);
+    vector<thread> workers;
+    for (unsigned h = 0; h < hilos; ++h) {
+        workers.emplace_back([&, h]() {
+            vector<string_view> mias;
+            vector<uint32_t> prios;
+            for (size_t i = 0; i < palabras.size(); ++i) {
+                if (palabras[i].empty() || dueno[unidad(palabras[i])] != h) continue;
+                mias.push_back(palabras[i]);
+                if (!prioridades.empty()) prios.push_back(prioridades[i]);
+            }
+            partes[h].reset(new Trie(variant, layout));
+            partes[h]->build_sorted(mias, prios);
+        });
+    }
+    for (thread& t : workers) t.join();
+    workers.clear();
+
+    // 3. reservar rangos y copiar (la raíz de cada parte no se copia)
+    vector<uint32_t> base_nodos(hilos), base_palabras(hilos);
+    vector<ChildSpan> base_hijos(hilos);
+    uint32_t siguiente_palabra = words.size();
+    for (unsigned h = 0; h < hilos; ++h) {
+        const Trie& t = *partes[h];
+        base_nodos[h] = nodes.alloc_span(t.nodes.size() - 2);
+        base_hijos[h] = children.reserve(t.children);
+        base_palabras[h] = siguiente_palabra;
+        siguiente_palabra += t.words.size() - 1;
+        global_counter = max(global_counter, t.global_counter);
+    }
+
+    for (unsigned h = 0; h < hilos; ++h) {
+        workers.emplace_back([&, h]() {
+            const Trie& t = *partes[h];
+            uint32_t nb = base_nodos[h], wb = base_palabras[h];
+            uint32_t raiz = root;
+            auto mapa = [nb, raiz](uint32_t x) { return x <= 1 ? x * raiz : nb + x - 2; };
+
+            for (uint32_t i = 2; i < t.nodes.size(); ++i) {
+                TrieNode n = t.nodes[i];
+                n.parent = mapa(n.parent);
+                n.best_terminal = mapa(n.best_terminal);
+                n.word = n.word ? wb + n.word - 1 : 0;
+                n.children = ChildStore::translate(n.children, base_hijos[h]);
+                n.topk = 0;
+                nodes[nb + i - 2] = n;
+            }
+            children.copy_from(t.children, base_hijos[h], mapa);
+        });
+    }
+    for (unsigned h = 0; h < hilos; ++h) {
+        const Trie& t = *partes[h];
+        for (uint32_t id = 1; id < t.words.size(); ++id) {
+            words.add(t.words.get(id), base_nodos[h] + t.words.entry(id).node - 2);
+        }
+    }
+    for (thread& t : workers) t.join();
+
+    // 4. coser bajo la raíz, fusionando nodos de profundidad 1 repetidos
+    for (unsigned h = 0; h < hilos; ++h) {
+        const Trie& t = *partes[h];
+        children.splice_free(t.children, base_hijos[h]);
+        size += t.size - 1;
+
+        t.children.for_each(t.nodes[t.root].children, [&](uint8_t key, uint32_t c) {
+            uint32_t copia = base_nodos[h] + c - 2;
+            uint32_t existente = children.find(nodes[root].children, key);
+            if (!existente) {
+                children.add(nodes[root].children, key, copia);
+                return;
+            }
+
+            TrieNode& dst = nodes[existente];
+            TrieNode& src = nodes[copia];
+            children.for_each(src.children, [&](uint8_t k, uint32_t hijo) {
+                children.add(dst.children, k, hijo);
+                nodes[hijo].parent = existente;
+            });
+            if (src.is_terminal) {
+                dst.is_terminal = true;
+                dst.word = src.word;
+                dst.priority = src.priority;
+                words.entry(src.word).node = existente;
+            }
+            offer_best(dst, src.best_terminal, src.best_priority);
+
+            free_node(copia);
+        });
+    }
+
+    TrieNode& r = nodes[root];
+    children.for_each(r.children, [&](uint8_t, uint32_t c) {
+        const TrieNode& n = nodes[c];
+        offer_best(r, n.best_terminal, n.best_priority);
+        if (n.is_terminal && n.priority > 0) offer_best(r, c, n.priority);
+    });
+
+    // la palabra vacía vive en la raíz, que no pertenece a ninguna parte
+    for (size_t i = 0; i < palabras.size(); ++i) {
+        if (!palabras[i].empty()) continue;
+        TrieNode* n = insert(palabras[i]);
+        if (!prioridades.empty()) {
+            n->priority = withPolicy(variant, [&](auto p) { return decltype(p)::merge(n->priority, prioridades[i]); });
+            if (variant == RECENT && n->priority >= global_counter) global_counter = n->priority + 1;
+        }
+    }
+
+    if (topk_k) enable_topk(topk_k, topk_max_depth);
+    if (jump_len) enable_jump_table(jump_len);
+}
+
+/**
+ * @brief Reconstruye los pools en el orden de un recorrido en profundidad
+ * con el hijo más caliente primero.
+ *
+ * Primero se calcula el orden nuevo y la traducción de índices; después se
+ * copian los nodos en ese orden, y el bloque de hijos de cada nodo se copia
+ * justo al visitarlo, así que también los bloques quedan en preorden.
+ */
+void Trie::compact() {
+    auto calor = [&](uint32_t n) {
+        const TrieNode& t = nodes[n];
+        uint32_t mejor = t.best_terminal ? nodes[t.best_terminal].priority : 0;
+        return max(mejor, t.is_terminal ? t.priority : 0u);
+    };
+
+    vector<uint32_t> orden;
+    orden.reserve(nodes.size() - 1);
+    vector<uint32_t> nuevo(nodes.size(), 0);
+    vector<uint32_t> pila{root};
+    vector<uint32_t> hijos;
+    while (!pila.empty()) {
+        uint32_t n = pila.back();
+        pila.pop_back();
+        nuevo[n] = (uint32_t)orden.size() + 1;
+        orden.push_back(n);
 
-        current = current->next[index];
+        hijos.clear();
+        children.for_each(nodes[n].children, [&](uint8_t, uint32_t child) { hijos.push_back(child); });
+        // el más caliente al final de la pila para visitarlo primero; en empate, orden de clave
+        stable_sort(hijos.begin(), hijos.end(), [&](uint32_t a, uint32_t b) { return calor(a) < calor(b); });
+        for (uint32_t h : hijos) pila.push_back(h);
     }
+    auto traducir = [&](uint32_t i) { return nuevo[i]; };
 
-    if (!current->is_terminal) {
-        current->is_terminal = true;
-        current->str = new string(w);
-        current->priority = 0;
+    EpochManager* concurrente = children.concurrent();
+    Pool<TrieNode> nodos;
+    ChildStore bloques;
+    for (uint32_t n : orden) {
+        uint32_t i = nodos.alloc();
+        TrieNode& t = nodos[i];
+        t = nodes[n];
+        t.parent = nuevo[t.parent];
+        t.best_terminal = nuevo[t.best_terminal];
+        t.children = bloques.copy_block(children, t.children, traducir);
+        if (t.word) words.entry(t.word).node = i;
+        // alloc_n deja huecos sin inicializar en el pool, así que se recorren sólo las listas en uso
+        for (uint32_t k = 0; t.topk && k < topk_k; ++k) {
+            topk_lists[t.topk + k].node = nuevo[topk_lists[t.topk + k].node];
+        }
     }
+
+    nodes = move(nodos);
+    children = move(bloques);
+    free_nodes = 0;  // los nodos libres no se copiaron
+    if (concurrente) children.set_concurrent(concurrente);
+    root = nuevo[root];
+    if (jump_len) enable_jump_table(jump_len);
 }
 
 /**
@@ -84,8 +485,8 @@ void Trie::insert(const string& w){
  */
 TrieNode* Trie::descend(TrieNode* v, const char c) {
     if (!v) return nullptr;
-    int idx = charToIndex(c);
-    return v->next[idx];
+    uint32_t idx = children.find(ChildStore::load(v->children), charToIndex(c));
+    return idx ? &nodes[idx] : nullptr;
 }
 
 /**
@@ -99,39 +500,987 @@ TrieNode* Trie::descend(TrieNode* v, const char c) {
  */
 TrieNode* Trie::autocomplete(TrieNode* v) {
     if (!v) return nullptr;
-    return v->best_terminal;
+    uint32_t best = __atomic_load_n(&v->best_terminal, __ATOMIC_ACQUIRE);
+    return best ? &nodes[best] : nullptr;
+}
+
+/**
+ * @brief Busca el nodo de un prefijo.
+ *
+ * Con la tabla activa, los primeros min(|p|, `jump_len`) caracteres se
+ * resuelven con una consulta a la tabla. Como la tabla tiene todos los
+ * prefijos existentes de ese largo, si no está el prefijo no existe.
+ *
+ * @param p Prefijo.
+ * @return Nodo del prefijo o `nullptr`.
+ */
+TrieNode* Trie::find_prefix(string_view p) {
+    size_t d = 0;
+    uint32_t current = root;
+    if (jump_len && !p.empty()) {
+        uint32_t clave = 0;
+        size_t hasta = min<size_t>(p.size(), jump_len);
+        for (; d < hasta; ++d) clave = PrefixIndex::extend(clave, charToIndex(p[d]));
+        current = jumps.find(clave);
+        if (!current) return nullptr;
+    }
+    for (; d < p.size(); ++d) {
+        current = children.find(ChildStore::load(nodes[current].children), charToIndex(p[d]));
+        if (!current) return nullptr;
+    }
+    return &nodes[current];
+}
+
+/**
+ * @brief Reconstruye la tabla de prefijos con un recorrido en profundidad
+ * limitado a `largo` niveles.
+ *
+ * @param largo Largo máximo (0 la desactiva).
+ */
+void Trie::enable_jump_table(uint32_t largo) {
+    if (largo > PrefixIndex::MAX_LEN) {
+        throw runtime_error("enable_jump_table: largo máximo " + to_string(PrefixIndex::MAX_LEN));
+    }
+    jumps.clear();
+    jump_len = largo;
+    if (!largo) return;
+
+    struct Pendiente { uint32_t node, clave, depth; };
+    vector<Pendiente> pila{{root, 0, 0}};
+    while (!pila.empty()) {
+        Pendiente p = pila.back();
+        pila.pop_back();
+        if (p.depth == largo) continue;
+        children.for_each(nodes[p.node].children, [&](uint8_t i, uint32_t child) {
+            uint32_t clave = PrefixIndex::extend(p.clave, i);
+            jumps.add(clave, child);
+            pila.push_back({child, clave, p.depth + 1});
+        });
+    }
+}
+
+/**
+ * @brief Búsqueda por lotes con las búsquedas intercaladas en una máquina de
+ * estados por ranura.
+ *
+ * Cada nivel del descenso son dos lecturas dependientes: el nodo (para su
+ * `ChildRef`) y su bloque de hijos (para encontrar la clave). Cada ranura
+ * alterna entre ambas etapas; al pasar de una a otra pide por adelantado la
+ * lectura siguiente y cede el turno, así que cuando la ranura vuelve a tocar
+ * el dato ya suele estar en caché. Una ranura que termina toma el siguiente
+ * prefijo pendiente.
+ */
+void Trie::lookup_batch(const vector<string_view>& prefijos, vector<TrieNode*>& nodos,
+                        vector<TrieNode*>& mejores, unsigned grupo) {
+    struct Ranura {
+        uint32_t query;   /**< Prefijo en curso (UINT32_MAX = libre) */
+        uint32_t pos;     /**< Caracteres ya consumidos */
+        uint32_t node;    /**< Nodo actual */
+        uint8_t key;      /**< Clave del próximo carácter */
+        bool block;       /**< True si el próximo paso lee el bloque de hijos */
+        ChildRef ref;     /**< Hijos del nodo actual */
+    };
+
+    size_t n = prefijos.size();
+    nodos.assign(n, nullptr);
+    mejores.assign(n, nullptr);
+    grupo = max(1u, min<unsigned>(grupo, (unsigned)max<size_t>(n, 1)));
+
+    vector<Ranura> ranuras(grupo);
+    size_t siguiente = 0, activas = 0;
+    auto tomar = [&](Ranura& r) {
+        if (siguiente < n) {
+            r = Ranura{(uint32_t)siguiente++, 0, root, 0, false, ChildRef{}};
+            activas++;
+        } else {
+            r.query = UINT32_MAX;
+        }
+    };
+    for (Ranura& r : ranuras) tomar(r);
+
+    while (activas > 0) {
+        for (Ranura& r : ranuras) {
+            if (r.query == UINT32_MAX) continue;
+            string_view q = prefijos[r.query];
+
+            if (r.block) {
+                // etapa 2: bloque de hijos en caché, buscar la clave
+                uint32_t child = children.find(r.ref, r.key);
+                if (!child) {
+                    activas--;
+                    tomar(r);
+                    continue;
+                }
+                r.node = child;
+                r.pos++;
+                r.block = false;
+                __builtin_prefetch(&nodes[child]);
+            } else {
+                // etapa 1: nodo en caché
+                TrieNode* v = &nodes[r.node];
+                if (r.pos == q.size()) {
+                    nodos[r.query] = v;
+                    mejores[r.query] = autocomplete(v);
+                    activas--;
+                    tomar(r);
+                    continue;
+                }
+                r.ref = ChildStore::load(v->children);
+                r.key = (uint8_t)charToIndex(q[r.pos]);
+                r.block = true;
+                children.prefetch(r.ref, r.key);
+            }
+        }
+    }
 }
 
 /**
  * @brief Actualiza la prioridad de un nodo terminal y propaga la mejor opción hacia la raíz.
  *
- * Dependiendo de la variante (`FREQUENCY` o `RECENT`) actualiza `v->priority`.
- * Luego, si corresponde, actualiza `best_priority` y `best_terminal` en los
- * ancestros hasta que ya no sea necesario propagar.
+ * Elige la política según la variante (`FREQUENCY` o `RECENT`) y delega en
+ * `update_priority<Policy>`. Para muchas actualizaciones seguidas conviene
+ * elegir la política una vez con `withPolicy` y llamar a la versión con
+ * plantilla directamente (ver `recorrer`).
  *
  * @param v Nodo terminal cuya prioridad se debe actualizar.
  */
 void Trie::update_priority(TrieNode* v) {
-    if (!v || !v->is_terminal) return;  // seguridad
-
-    // Actualizar la prioridad según la variante
-    if (variant == FREQUENCY) {
-        v->priority += 1;
-    } else if (variant == RECENT) {
-        v->priority = global_counter++;
-    }
-
-    // Propagar hacia la raíz
-    TrieNode* node = v->parent;
-    while (node != nullptr) {
-        if (node->best_priority < v->priority) {
-            node->best_priority = v->priority;
-            node->best_terminal = v;
-            node = node->parent;
+    withPolicy(variant, [&](auto p) { update_priority<decltype(p)>(v); });
+}
+
+/**
+ * @brief Propaga la prioridad nueva del terminal `v` hacia la raíz.
+ *
+ * Actualiza `best_priority` y `best_terminal` en los ancestros hasta que ya
+ * no sea necesario subir, y luego las listas top-k.
+ *
+ * @param v Nodo terminal cuya prioridad acaba de cambiar.
+ */
+void Trie::propagate(TrieNode* v) {
+    // best_terminal se publica atómicamente para los lectores concurrentes;
+    // el terminal ya es visible desde su inserción
+    uint32_t self = words.entry(v->word).node;
+    uint32_t node = v->parent;
+    while (node != 0) {
+        TrieNode& n = nodes[node];
+        propagation_steps++;
+        if (n.best_priority < v->priority) {
+            n.best_priority = v->priority;
+            __atomic_store_n(&n.best_terminal, self, __ATOMIC_RELEASE);
+            node = n.parent;
         } else {
             break;  // ya no se necesita subir más
         }
     }
+
+    if (topk_k) update_topk(self);
+}
+
+/**
+ * @brief Propagación del modo RECENT perezoso.
+ *
+ * El mejor terminal de un nodo es el último usado de su subárbol. Si un
+ * ancestro ya sugiere `v`, también lo hacen todos los nodos entre él y `v`,
+ * así que los ancestros que ya sugieren `v` son un tramo inferior del camino
+ * y los que no, el tramo superior hasta la raíz. Sólo se escribe el tramo
+ * superior; si la raíz ya sugiere `v` no hay nada que hacer.
+ *
+ * @param v Nodo terminal cuya prioridad acaba de cambiar.
+ */
+void Trie::propagate_lazy(TrieNode* v) {
+    uint32_t self = words.entry(v->word).node;
+    if (__atomic_load_n(&nodes[root].best_terminal, __ATOMIC_RELAXED) != self) {
+        uint32_t node = v->parent;
+        while (node != 0 && nodes[node].best_terminal == self) node = nodes[node].parent;
+        for (; node != 0; node = nodes[node].parent) {
+            TrieNode& n = nodes[node];
+            propagation_steps++;
+            n.best_priority = v->priority;
+            __atomic_store_n(&n.best_terminal, self, __ATOMIC_RELEASE);
+        }
+    }
+
+    if (topk_k) update_topk(self);
+}
+
+/**
+ * @brief Corre todas las prioridades guardadas con `rescale` de la política
+ * (ver `RecentPolicy` y `DecayedPolicy`).
+ *
+ * El corrimiento es uniforme, así que los mejores terminales y el orden de
+ * las listas top-k siguen siendo válidos: sólo se reescriben los valores.
+ * Pasa una vez cada muchos millones de usos.
+ */
+void Trie::rescale() {
+    withPolicy(variant, [&](auto p) {
+        using Policy = decltype(p);
+        for (uint32_t i = 1; i < nodes.size(); ++i) {
+            TrieNode& n = nodes[i];
+            n.priority = Policy::rescale(n.priority);
+            n.best_priority = Policy::rescale(n.best_priority);
+            for (uint32_t k = 0; n.topk && k < topk_k; ++k) {
+                topk_lists[n.topk + k].priority = Policy::rescale(topk_lists[n.topk + k].priority);
+            }
+        }
+        global_counter = Policy::rescale_counter(global_counter);
+    });
+}
+
+/**
+ * @brief Activa o desactiva el modo RECENT perezoso.
+ *
+ * Al desactivarlo las cotas de `best_priority` siguen sirviendo: la
+ * propagación normal de RECENT sólo las compara con un uso nuevo, que es
+ * mayor que todas.
+ *
+ * @param on true para activarlo.
+ */
+void Trie::set_lazy_recent(bool on) {
+    if (on && variant != RECENT) throw runtime_error("set_lazy_recent: sólo para la variante RECENT");
+    lazy_recent = on;
+}
+
+/**
+ * @brief Repara el mejor terminal de `node` y de sus ancestros después de que
+ * cambió la prioridad del terminal `self` (o dejó de ser terminal).
+ *
+ * En un ancestro que no sugería a `self` basta compararlo con su mejor
+ * terminal actual: si no lo supera, ni ese nodo ni los de más arriba
+ * cambian. Sólo donde `self` era el mejor hay que recalcular, y para eso
+ * basta el resumen de cada hijo (él mismo si es terminal y su mejor terminal),
+ * sin recorrer subárboles: O(hijos) por nodo y O(profundidad * hijos) en
+ * total. En modo RECENT perezoso `best_priority` es sólo una cota, así que la
+ * prioridad de cada candidato se lee del propio terminal.
+ *
+ * @param node Nodo desde el cual reparar (0 = nada).
+ * @param self Terminal que cambió.
+ */
+void Trie::repair_best(uint32_t node, uint32_t self) {
+    auto prioridad_mejor = [&](const TrieNode& n) {
+        return lazy_recent && n.best_terminal ? nodes[n.best_terminal].priority : n.best_priority;
+    };
+    uint32_t p = nodes[self].is_terminal ? nodes[self].priority : 0;
+
+    for (; node != 0; node = nodes[node].parent) {
+        TrieNode& n = nodes[node];
+        propagation_steps++;
+
+        uint32_t best = 0, prio = 0;
+        auto ofrecer = [&](uint32_t candidato, uint32_t q) {
+            if (q > prio || (q > 0 && q == prio && candidato < best)) {
+                best = candidato;
+                prio = q;
+            }
+        };
+
+        if (n.best_terminal != self) {
+            ofrecer(n.best_terminal, prioridad_mejor(n));
+            ofrecer(self, p);
+            if (best != self) break;  // sigue sugiriendo lo mismo, igual que sus ancestros
+        } else {
+            children.for_each(n.children, [&](uint8_t, uint32_t c) {
+                const TrieNode& h = nodes[c];
+                if (h.is_terminal) ofrecer(c, h.priority);
+                if (h.best_terminal) ofrecer(h.best_terminal, prioridad_mejor(h));
+            });
+        }
+        n.best_priority = prio;
+        __atomic_store_n(&n.best_terminal, best, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Rehace las listas top-k que contienen al terminal `self` después de
+ * que su prioridad bajó o de que dejó de ser terminal.
+ *
+ * Una lista que no contiene a `self` no cambia, y tampoco las de sus
+ * ancestros (si `self` no estaba entre los k mejores de un subárbol, menos
+ * lo está en uno que lo contiene), así que se sube sólo hasta ahí. Cada lista
+ * se rehace con un `CompletionIterator` limitado a k resultados.
+ *
+ * @param self Índice del terminal.
+ */
+void Trie::refresh_topk(uint32_t self) {
+    for (uint32_t node = nodes[self].parent; node != 0; node = nodes[node].parent) {
+        TrieNode& n = nodes[node];
+        if (!n.topk) continue;  // nodo profundo, sin lista
+        TopKEntry* list = &topk_lists[n.topk];
+
+        bool esta = false;
+        for (uint32_t i = 0; i < topk_k; ++i) esta |= list[i].node == self;
+        if (!esta) break;
+
+        CompletionIterator it(*this, &n, topk_k);
+        uint32_t i = 0;
+        for (TrieNode* t; i < topk_k && (t = it.next()) != nullptr; ++i) {
+            list[i] = TopKEntry{words.entry(t->word).node, t->priority};
+        }
+        for (; i < topk_k; ++i) list[i] = TopKEntry{0, 0};
+    }
+}
+
+/**
+ * @brief Devuelve un nodo (ya desenganchado de su padre) a la lista libre,
+ * junto con su bloque de hijos y su lista top-k.
+ * @param idx Índice del nodo.
+ */
+void Trie::free_node(uint32_t idx) {
+    TrieNode& n = nodes[idx];
+    children.clear(n.children);
+    if (n.topk) {
+        topk_lists[n.topk].node = free_topk;  // la lista libre se enlaza por su primera entrada
+        free_topk = n.topk;
+    }
+    n = TrieNode();
+    n.word = free_nodes;
+    free_nodes = idx;
+    size--;
+}
+
+/**
+ * @brief Borra una palabra.
+ *
+ * 1. El nodo deja de ser terminal y su prioridad pasa a 0.
+ * 2. Se reparan los mejores terminales desde el padre y se rehacen las
+ *    listas top-k que lo contenían.
+ * 3. Fuera del modo concurrente se libera el id de la palabra (con tablas
+ *    de sucesores, en lotes: ver `release_removed_ids`) y, subiendo desde
+ *    el nodo, cada nodo sin hijos ni palabra: se quita del bloque de su
+ *    padre, de la tabla de prefijos y pasa a la lista libre.
+ *
+ * @param w Palabra a borrar.
+ * @return True si la palabra estaba en el Trie.
+ */
+bool Trie::remove(string_view w) {
+    TrieNode* v = find_prefix(w);
+    if (!is_terminal(v)) return false;
+    uint32_t self = words.entry(v->word).node;
+
+    __atomic_store_n(&v->is_terminal, false, __ATOMIC_RELEASE);
+    v->priority = 0;
+    repair_best(v->parent, self);
+    if (topk_k) refresh_topk(self);
+    if (children.concurrent()) return true;
+
+    if (successors.capacity()) {
+        // las tablas de sucesores pueden nombrar el id: se libera junto con
+        // otros en una sola pasada por las tablas (ver `release_removed_ids`)
+        words.entry(v->word).node = 0;
+        removed_ids.push_back(v->word);
+        if (removed_ids.size() > successors.tables() / 8) release_removed_ids();
+    } else {
+        words.remove(v->word);
+    }
+    v->word = 0;
+
+    // claves de los prefijos de w en la tabla de saltos
+    uint32_t claves[PrefixIndex::MAX_LEN + 1];
+    claves[0] = 0;
+    for (size_t d = 0; d < jump_len && d < w.size(); ++d) {
+        claves[d + 1] = PrefixIndex::extend(claves[d], charToIndex(w[d]));
+    }
+
+    uint32_t node = self;
+    for (size_t d = w.size(); node != root && !nodes[node].is_terminal && nodes[node].children.count == 0; --d) {
+        uint32_t padre = nodes[node].parent;
+        children.remove(nodes[padre].children, charToIndex(w[d - 1]));
+        if (d <= jump_len) jumps.erase(claves[d]);
+        free_node(node);
+        node = padre;
+    }
+    return true;
+}
+
+/**
+ * @brief Fija la prioridad de una palabra y repara lo que depende de ella.
+ *
+ * Los mejores terminales se reparan con `repair_best`. En las listas top-k
+ * una subida se ofrece como en `update_priority` y una bajada rehace las
+ * listas que la contenían.
+ *
+ * @param w Palabra.
+ * @param prioridad Prioridad nueva.
+ * @return True si la palabra estaba en el Trie.
+ */
+bool Trie::set_priority(string_view w, uint32_t prioridad) {
+    TrieNode* v = find_prefix(w);
+    if (!is_terminal(v)) return false;
+    uint32_t self = words.entry(v->word).node;
+
+    uint32_t antes = v->priority;
+    v->priority = prioridad;
+    if (variant == RECENT && prioridad >= global_counter) global_counter = prioridad + 1;
+    repair_best(v->parent, self);
+
+    if (topk_k && prioridad > antes) update_topk(self);
+    if (topk_k && prioridad < antes) refresh_topk(self);
+    return true;
+}
+
+/**
+ * @brief Envejece todas las prioridades.
+ *
+ * Cada política escala a su manera (`scale`); en DECAYED es una resta en
+ * forma logarítmica. En RECENT el orden entre palabras se conserva y el
+ * contador global baja a la mayor prioridad más uno, para que los usos
+ * siguientes sigan siendo los más recientes sin que el contador se acerque
+ * al desborde.
+ *
+ * @param factor Factor en [0, 1].
+ */
+void Trie::decay(double factor) {
+    if (!(factor >= 0 && factor <= 1)) throw runtime_error("decay: el factor debe estar en [0, 1]");
+
+    uint32_t maxima = 0;
+    for (uint32_t id = 1; id < words.size(); ++id) {
+        uint32_t t = words.entry(id).node;
+        if (!t || !nodes[t].is_terminal) continue;
+        nodes[t].priority = withPolicy(variant, [&](auto p) { return decltype(p)::scale(nodes[t].priority, factor); });
+        maxima = max(maxima, nodes[t].priority);
+    }
+    if (variant == RECENT) global_counter = maxima + 1;
+
+    rebuild_best();
+    if (topk_k) enable_topk(topk_k, topk_max_depth);
+}
+
+/**
+ * @brief Ofrece el terminal `self` (con su nueva prioridad) a las listas top-k
+ * de sus ancestros.
+ *
+ * Si el terminal ya está en la lista se corrige su prioridad y sube; si no,
+ * entra desplazando al último cuando lo supera. Si no logra entrar a la lista
+ * de un nodo tampoco puede entrar a la de sus ancestros (su subárbol contiene
+ * al del nodo), así que ahí se detiene. Costo: O(profundidad * k).
+ *
+ * @param self Índice del terminal cuya prioridad cambió.
+ */
+void Trie::update_topk(uint32_t self) {
+    const TrieNode& t = nodes[self];
+    uint32_t p = t.priority;
+    uint32_t depth = words.entry(t.word).length;  // profundidad del terminal
+
+    for (uint32_t node = t.parent; node != 0; node = nodes[node].parent) {
+        depth--;
+        if (depth > topk_max_depth) continue;
+
+        TrieNode& n = nodes[node];
+        if (!n.topk) {
+            if (!free_topk) {
+                n.topk = topk_lists.alloc_n(topk_k);
+            } else {
+                n.topk = free_topk;
+                free_topk = topk_lists[n.topk].node;
+            }
+            for (uint32_t i = 0; i < topk_k; ++i) topk_lists[n.topk + i] = TopKEntry{0, 0};
+        }
+        TopKEntry* list = &topk_lists[n.topk];
+
+        // posición actual del terminal o, si no está, la última entrada
+        uint32_t pos = 0;
+        while (pos < topk_k && list[pos].node != 0 && list[pos].node != self) pos++;
+        if (pos == topk_k) {
+            pos = topk_k - 1;
+            if (list[pos].priority >= p) break;  // no entra aquí ni más arriba
+        }
+
+        // sube mientras supere estrictamente al anterior (los empates no se adelantan)
+        while (pos > 0 && list[pos - 1].priority < p) {
+            list[pos] = list[pos - 1];
+            pos--;
+        }
+        list[pos] = TopKEntry{self, p};
+    }
+}
+
+/**
+ * @brief Activa las listas top-k y las reconstruye con las prioridades actuales.
+ *
+ * @param k Capacidad de cada lista (0 las desactiva).
+ * @param max_depth Profundidad máxima de los nodos con lista.
+ */
+void Trie::enable_topk(uint32_t k, uint32_t max_depth) {
+    topk_lists.clear();
+    free_topk = 0;
+    for (uint32_t i = 1; i < nodes.size(); ++i) nodes[i].topk = 0;
+    topk_k = k;
+    topk_max_depth = max_depth;
+    if (!k) return;
+
+    // ofrecer los terminales en orden ascendente de prioridad deja en cada
+    // lista los k mejores, igual que si se hubieran mantenido desde el inicio
+    vector<uint32_t> terminales;
+    for (uint32_t id = 1; id < words.size(); ++id) {
+        uint32_t t = words.entry(id).node;
+        if (t && nodes[t].is_terminal && nodes[t].priority > 0) terminales.push_back(t);
+    }
+    stable_sort(terminales.begin(), terminales.end(), [&](uint32_t a, uint32_t b) {
+        return nodes[a].priority < nodes[b].priority;
+    });
+    for (uint32_t t : terminales) update_topk(t);
+}
+
+/**
+ * @brief Devuelve las `k` mejores sugerencias bajo `v`.
+ *
+ * @param v Nodo desde el cual se consulta.
+ * @param k Cantidad de sugerencias.
+ * @return Terminales en orden de prioridad descendente.
+ */
+vector<TrieNode*> Trie::autocomplete_topk(TrieNode* v, uint32_t k) {
+    vector<TrieNode*> out;
+    if (!v) return out;
+    if (!v->topk || k > topk_k) {
+        // sin lista (nodo profundo o sin prioridades aún): recorrer el subárbol
+        if (v->best_terminal == 0) return out;
+        return autocomplete_topk_scan(v, k);
+    }
+
+    const TopKEntry* list = &topk_lists[v->topk];
+    for (uint32_t i = 0; i < k && list[i].node != 0; ++i) {
+        out.push_back(&nodes[list[i].node]);
+    }
+    return out;
+}
+
+/**
+ * @brief Calcula las `k` mejores sugerencias recorriendo el subárbol de `v`.
+ *
+ * Sirve como referencia para comparar con las listas top-k y como respaldo
+ * para nodos sin lista. Igual que `autocomplete`, no incluye a `v` y sólo
+ * considera terminales con prioridad mayor a 0.
+ *
+ * @param v Nodo desde el cual se consulta.
+ * @param k Cantidad de sugerencias.
+ * @return Terminales en orden de prioridad descendente.
+ */
+vector<TrieNode*> Trie::autocomplete_topk_scan(TrieNode* v, uint32_t k) {
+    vector<uint32_t> terminales;
+    vector<uint32_t> pila;
+    if (v) children.for_each(v->children, [&](uint8_t, uint32_t c) { pila.push_back(c); });
+
+    while (!pila.empty()) {
+        uint32_t idx = pila.back();
+        pila.pop_back();
+        const TrieNode& n = nodes[idx];
+        if (n.is_terminal && n.priority > 0) terminales.push_back(idx);
+        children.for_each(n.children, [&](uint8_t, uint32_t c) { pila.push_back(c); });
+    }
+
+    size_t m = min<size_t>(k, terminales.size());
+    partial_sort(terminales.begin(), terminales.begin() + m, terminales.end(),
+                 [&](uint32_t a, uint32_t b) { return nodes[a].priority > nodes[b].priority; });
+
+    vector<TrieNode*> out;
+    for (size_t i = 0; i < m; ++i) out.push_back(&nodes[terminales[i]]);
+    return out;
+}
+
+/**
+ * @brief Autocompletado con hasta `max_edits` errores respecto de `prefijo`.
+ *
+ * Cada nodo alcanzado lleva la fila de la DP de Levenshtein entre el camino
+ * desde la raíz y `prefijo` (m + 1 bytes, saturados en `max_edits + 1`). Si
+ * el mínimo de la fila supera `max_edits` ningún descendiente puede calzar y
+ * la rama se descarta; si la última celda no lo supera, el camino ya calza
+ * con el prefijo y todo el subárbol es candidato, así que se recorre sin
+ * más filas. Las entradas salen de un heap ordenado por la cota exacta del
+ * subárbol (como en `CompletionIterator`), de modo que los terminales se
+ * entregan en orden de prioridad y la búsqueda se corta al tener `k`: las
+ * ramas que quedan en el heap no pueden ganarle al k-ésimo resultado.
+ *
+ * @param prefijo Prefijo escrito.
+ * @param max_edits Ediciones permitidas.
+ * @param k Cantidad de sugerencias.
+ * @return Terminales en orden de prioridad descendente.
+ */
+vector<TrieNode*> Trie::fuzzy_autocomplete(string_view prefijo, uint32_t max_edits, uint32_t k) {
+    vector<TrieNode*> out;
+    if (k == 0) return out;
+
+    const size_t m = prefijo.size();
+    const int tope = (int)min<uint32_t>(max_edits, 254) + 1;  // toda distancia mayor se guarda como `tope`
+    vector<uint8_t> claves(m);
+    for (size_t j = 0; j < m; ++j) claves[j] = (uint8_t)charToIndex(prefijo[j]);
+
+    enum : uint8_t { TERMINAL, CALZA, FILA };
+    struct Entrada {
+        uint32_t cota;   /**< Prioridad (terminal) o cota del subárbol */
+        uint32_t nodo;   /**< Índice del nodo */
+        uint32_t fila;   /**< Posición de la fila en `filas` (sólo FILA) */
+        uint8_t tipo;    /**< TERMINAL: se entrega; CALZA: subárbol completo; FILA: sigue la DP */
+    };
+    auto menor = [](const Entrada& a, const Entrada& b) {
+        if (a.cota != b.cota) return a.cota < b.cota;
+        return a.tipo > b.tipo;  // en empate, terminales primero
+    };
+    // en RECENT perezoso best_priority es sólo una cota: se lee del mejor terminal
+    auto cota = [&](const TrieNode& n) {
+        uint32_t c = !lazy_recent ? n.best_priority : n.best_terminal ? nodes[n.best_terminal].priority : 0;
+        if (n.is_terminal && n.priority > c) c = n.priority;
+        return c;
+    };
+    vector<Entrada> heap;
+    auto meter = [&](const Entrada& e) {
+        if (e.cota == 0) return;
+        heap.push_back(e);
+        push_heap(heap.begin(), heap.end(), menor);
+    };
+
+    vector<uint8_t> filas(m + 1);  // filas de la DP, m + 1 bytes cada una
+    for (size_t j = 0; j <= m; ++j) filas[j] = (uint8_t)min<size_t>(j, tope);
+    meter(Entrada{cota(nodes[root]), root, 0, filas[m] < tope ? CALZA : FILA});
+
+    vector<uint8_t> nueva(m + 1);
+    while (!heap.empty() && out.size() < k) {
+        pop_heap(heap.begin(), heap.end(), menor);
+        Entrada e = heap.back();
+        heap.pop_back();
+        const TrieNode& n = nodes[e.nodo];
+
+        if (e.tipo == TERMINAL) {
+            out.push_back(&nodes[e.nodo]);
+        } else if (e.tipo == CALZA) {
+            if (n.is_terminal && n.priority > 0) meter(Entrada{n.priority, e.nodo, 0, TERMINAL});
+            children.for_each(n.children, [&](uint8_t, uint32_t c) {
+                meter(Entrada{cota(nodes[c]), c, 0, CALZA});
+            });
+        } else {
+            // la fila sólo depende de la clave: se descarta por distancia sin leer el hijo
+            children.for_each(n.children, [&](uint8_t clave, uint32_t c) {
+                const uint8_t* fila = &filas[e.fila];
+                int minimo = min(fila[0] + 1, tope);
+                nueva[0] = (uint8_t)minimo;
+                for (size_t j = 1; j <= m; ++j) {
+                    int v = min(min(fila[j], nueva[j - 1]) + 1, fila[j - 1] + (claves[j - 1] != clave));
+                    v = min(v, tope);
+                    nueva[j] = (uint8_t)v;
+                    minimo = min(minimo, v);
+                }
+                if (minimo >= tope) return;             // ninguna extensión vuelve a calzar
+                uint32_t b = cota(nodes[c]);
+                if (b == 0) return;
+                if (nueva[m] < tope) {                  // el camino ya calza: entra todo el subárbol
+                    meter(Entrada{b, c, 0, CALZA});
+                    return;
+                }
+                uint32_t pos = (uint32_t)filas.size();
+                filas.insert(filas.end(), nueva.begin(), nueva.end());
+                meter(Entrada{b, c, pos, FILA});
+            });
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Activa (o desactiva con 0) las tablas de sucesores, vacías.
+ * @param capacidad Sucesores por palabra.
+ */
+void Trie::enable_successors(uint32_t capacidad) {
+    for (uint32_t id : removed_ids) words.remove(id);
+    removed_ids.clear();
+    successors.reset(capacidad);
+}
+
+/**
+ * @brief Quita de las tablas de sucesores los ids borrados pendientes y los
+ * libera para que `insert` los reutilice.
+ *
+ * Se llama cuando los pendientes superan un octavo de las tablas, así que
+ * cada borrado cuesta en promedio O(capacidad) y los ids retenidos quedan
+ * acotados.
+ */
+void Trie::release_removed_ids() {
+    successors.forget_if([&](uint32_t id) { return words.entry(id).node == 0; });
+    for (uint32_t id : removed_ids) words.remove(id);
+    removed_ids.clear();
+}
+
+/**
+ * @brief Suma una observación del bigrama (anterior, siguiente).
+ *
+ * Las tablas se indexan por id de palabra, que `compact` conserva, así que
+ * sobreviven a la compactación.
+ *
+ * @param anterior Terminal de la palabra anterior.
+ * @param siguiente Terminal de la palabra siguiente.
+ */
+void Trie::observe_successor(const TrieNode* anterior, const TrieNode* siguiente) {
+    if (!successors.capacity() || !is_terminal(anterior) || !is_terminal(siguiente)) return;
+    successors.observe(anterior->word, siguiente->word);
+}
+
+/**
+ * @brief Predice las `k` palabras más frecuentes después de la de `anterior`.
+ *
+ * El bloque ya está ordenado por conteo: basta leer sus primeras entradas y
+ * traducir cada id a su terminal.
+ *
+ * @param anterior Terminal de la palabra anterior.
+ * @param k Cantidad de predicciones.
+ * @return Terminales en orden de conteo descendente.
+ */
+vector<TrieNode*> Trie::predict_next(const TrieNode* anterior, uint32_t k) {
+    vector<TrieNode*> out;
+    if (!is_terminal(anterior)) return out;
+    const SuccessorEntry* e = successors.find(anterior->word);
+    if (!e) return out;
+    for (uint32_t i = 0; i < successors.capacity() && e[i].word != 0 && out.size() < k; ++i) {
+        uint32_t nodo = words.entry(e[i].word).node;
+        if (nodo && nodes[nodo].is_terminal) out.push_back(&nodes[nodo]);
+    }
+    return out;
+}
+
+/**
+ * @brief Orden del heap de `CompletionIterator`: mayor cota primero y, en
+ * empate, los terminales antes que los subárboles.
+ */
+bool CompletionIterator::menor_cota(const Entry& a, const Entry& b) {
+    if (a.bound != b.bound) return a.bound < b.bound;
+    return !a.terminal && b.terminal;
+}
+
+/**
+ * @brief Construye el iterador sembrando el heap con los hijos de `v`.
+ *
+ * @param t Trie a recorrer.
+ * @param v Nodo del prefijo.
+ * @param limit Cantidad máxima de resultados.
+ * @param min_prio Prioridad mínima de los resultados.
+ */
+CompletionIterator::CompletionIterator(Trie& t, TrieNode* v, uint32_t limit, uint32_t min_prio)
+    : trie(t), remaining(limit), min_priority(min_prio) {
+    if (!v) return;
+    trie.children.for_each(v->children, [&](uint8_t, uint32_t c) { push_subtree(c); });
+}
+
+/**
+ * @brief Agrega al heap el subárbol con raíz `node` si su cota alcanza el mínimo.
+ * @param node Índice de la raíz del subárbol.
+ */
+void CompletionIterator::push_subtree(uint32_t node) {
+    const TrieNode& n = trie.nodes[node];
+    // la prioridad se lee del mejor terminal: en RECENT perezoso best_priority es sólo una cota
+    uint32_t bound = n.best_terminal ? trie.nodes[n.best_terminal].priority : 0;
+    if (n.is_terminal && n.priority > bound) bound = n.priority;
+    push(Entry{bound, node, false});
+}
+
+/**
+ * @brief Inserta una entrada en el heap manteniéndolo acotado.
+ *
+ * Cada entrada garantiza al menos un resultado con prioridad igual a su cota,
+ * así que sólo las `remaining` mejores pueden llegar a entregarse. Cuando el
+ * heap dobla ese tamaño se descarta el resto (costo amortizado O(1)).
+ *
+ * @param e Entrada a insertar.
+ */
+void CompletionIterator::push(const Entry& e) {
+    if (e.bound < min_priority || remaining == 0) return;
+    heap.push_back(e);
+    push_heap(heap.begin(), heap.end(), menor_cota);
+
+    if (remaining < UINT32_MAX / 2 && heap.size() >= 2 * (size_t)remaining + 32) {
+        nth_element(heap.begin(), heap.begin() + remaining, heap.end(),
+                    [](const Entry& a, const Entry& b) { return menor_cota(b, a); });
+        heap.resize(remaining);
+        make_heap(heap.begin(), heap.end(), menor_cota);
+    }
+}
+
+/**
+ * @brief Expande subárboles hasta que el mejor elemento del heap sea un terminal.
+ *
+ * @return Siguiente terminal en orden de prioridad, o `nullptr` al terminar.
+ */
+TrieNode* CompletionIterator::next() {
+    while (!heap.empty() && remaining > 0) {
+        pop_heap(heap.begin(), heap.end(), menor_cota);
+        Entry e = heap.back();
+        heap.pop_back();
+
+        if (e.terminal) {
+            remaining--;
+            return &trie.nodes[e.node];
+        }
+
+        const TrieNode& n = trie.nodes[e.node];
+        if (n.is_terminal) push(Entry{n.priority, e.node, true});
+        trie.children.for_each(n.children, [&](uint8_t, uint32_t c) { push_subtree(c); });
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Crea el cursor en la raíz.
+ * @param t Trie a recorrer.
+ */
+TrieCursor::TrieCursor(Trie& t) : trie(t), path{t.get_root()}, missing(0) {}
+
+/**
+ * @brief Baja un nivel desde el nodo actual; si el prefijo ya no existía,
+ * sólo cuenta el carácter.
+ *
+ * @param c Carácter escrito.
+ * @return True si el prefijo existe.
+ */
+bool TrieCursor::push(char c) {
+    if (!missing) {
+        TrieNode* child = trie.descend(path.back(), c);
+        if (child) {
+            path.push_back(child);
+            return true;
+        }
+    }
+    missing++;
+    return false;
+}
+
+/**
+ * @brief Deshace el último `push`.
+ */
+void TrieCursor::pop() {
+    if (missing) missing--;
+    else if (path.size() > 1) path.pop_back();
+}
+
+/**
+ * @brief Deja sólo la raíz en la pila.
+ */
+void TrieCursor::reset() {
+    path.resize(1);
+    missing = 0;
+}
+
+/**
+ * @brief Cabecera de un snapshot del Trie (ver `snapshot.hpp`).
+ */
+struct TrieSnapshotHeader {
+    char magic[8];                   /**< "TRIESNAP" */
+    uint32_t version;                /**< Versión del formato */
+    uint32_t endian;                 /**< 0x01020304 en el orden de bytes de quien guardó */
+    uint32_t header_bytes;           /**< `sizeof(TrieSnapshotHeader)` */
+    int32_t variant;                 /**< Variante (FREQUENCY/RECENT/DECAYED) */
+    int32_t layout;                  /**< Layout de los hijos */
+    uint32_t root;                   /**< Índice de la raíz */
+    uint32_t global_counter;         /**< Contador de RECENT y DECAYED */
+    uint32_t topk_k;                 /**< Capacidad de las listas top-k */
+    uint32_t topk_max_depth;         /**< Profundidad máxima con lista top-k */
+    uint32_t free4;                  /**< Lista libre de Node4 */
+    uint32_t free16;                 /**< Lista libre de Node16 */
+    uint32_t free27;                 /**< Lista libre de Node27 */
+    uint32_t free_nodes;             /**< Lista de nodos liberados */
+    uint32_t successor_capacity;     /**< Sucesores por palabra (0 = sin tablas) */
+    uint32_t free_topk;              /**< Lista de listas top-k liberadas */
+    uint64_t size;                   /**< Cantidad de nodos */
+    uint64_t propagation_steps;      /**< Pasos de propagación acumulados */
+    SnapshotSection sections[9];     /**< Nodos, Node4, Node16, Node27, entradas, caracteres, top-k, sucesores (2) */
+    uint64_t checksum;               /**< Checksum de las secciones y de la cabecera previa */
+};
+
+static const char TRIE_SNAPSHOT_MAGIC[8] = {'T', 'R', 'I', 'E', 'S', 'N', 'A', 'P'};
+static const uint32_t TRIE_SNAPSHOT_VERSION = 4;
+
+/**
+ * @brief Guarda el Trie en un snapshot binario.
+ *
+ * Las secciones son la imagen de cada pool, así que guardar es escribir
+ * memoria secuencialmente. Los bloques de hijos retirados en modo
+ * concurrente que aún no se reutilizan quedan fuera de las listas libres.
+ *
+ * @param ruta Ruta del archivo.
+ */
+void Trie::save(const string& ruta) const {
+    TrieSnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRIE_SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = TRIE_SNAPSHOT_VERSION;
+    h.endian = 0x01020304;
+    h.header_bytes = sizeof(h);
+    h.variant = variant;
+    h.layout = layout;
+    h.root = root;
+    h.global_counter = global_counter;
+    h.topk_k = topk_k;
+    h.topk_max_depth = topk_max_depth;
+    h.free4 = children.free_list4();
+    h.free16 = children.free_list16();
+    h.free27 = children.free_list27();
+    h.free_nodes = free_nodes;
+    h.free_topk = free_topk;
+    h.successor_capacity = successors.capacity();
+    h.size = size;
+    h.propagation_steps = propagation_steps;
+
+    SnapshotWriter out(ruta, sizeof(h));
+    int i = 0;
+    h.sections[i++] = out.write(nodes);
+    children.for_each_pool([&](const auto& pool) { h.sections[i++] = out.write(pool); });
+    words.for_each_pool([&](const auto& pool) { h.sections[i++] = out.write(pool); });
+    h.sections[i++] = out.write(topk_lists);
+    successors.for_each_pool([&](const auto& pool) { h.sections[i++] = out.write(pool); });
+
+    Checksum sum = out.checksum();
+    sum.update(&h, offsetof(TrieSnapshotHeader, checksum));
+    h.checksum = sum.digest();
+    out.finish(&h, sizeof(h));
+}
+
+/**
+ * @brief Carga un snapshot guardado con `save`.
+ *
+ * Primero valida la cabecera, que cada sección quepa en el archivo y el
+ * checksum; recién entonces copia las secciones a los pools. No hay punteros
+ * que corregir porque todo se referencia por índice.
+ *
+ * @param ruta Ruta del archivo.
+ */
+void Trie::load(const string& ruta) {
+    SnapshotReader in(ruta);
+    TrieSnapshotHeader h;
+    in.header(&h, sizeof(h));
+    if (memcmp(h.magic, TRIE_SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) in.fail("no es un snapshot de Trie");
+    if (h.version != TRIE_SNAPSHOT_VERSION) in.fail("versión " + to_string(h.version));
+    if (h.endian != 0x01020304 || h.header_bytes != sizeof(h)) in.fail("formato de otra plataforma");
+
+    Checksum sum;
+    int i = 0;
+    in.check<decltype(nodes)>(h.sections[i++], sum);
+    children.for_each_pool([&](auto& pool) { in.check<decay_t<decltype(pool)>>(h.sections[i++], sum); });
+    words.for_each_pool([&](auto& pool) { in.check<decay_t<decltype(pool)>>(h.sections[i++], sum); });
+    in.check<decltype(topk_lists)>(h.sections[i++], sum);
+    successors.for_each_pool([&](auto& pool) { in.check<decay_t<decltype(pool)>>(h.sections[i++], sum); });
+    sum.update(&h, offsetof(TrieSnapshotHeader, checksum));
+    if (sum.digest() != h.checksum) in.fail("checksum");
+    if (h.root == 0 || h.root >= h.sections[0].count) in.fail("raíz fuera de rango");
+
+    i = 0;
+    in.read(nodes, h.sections[i++]);
+    children.for_each_pool([&](auto& pool) { in.read(pool, h.sections[i++]); });
+    words.for_each_pool([&](auto& pool) { in.read(pool, h.sections[i++]); });
+    in.read(topk_lists, h.sections[i++]);
+    successors.for_each_pool([&](auto& pool) { in.read(pool, h.sections[i++]); });
+    children.set_free_lists(h.free4, h.free16, h.free27);
+    successors.restore(h.successor_capacity);
+    // ids borrados que aún no se liberaban: se quitan de las tablas antes de reutilizarlos
+    successors.forget_if([&](uint32_t id) { return words.entry(id).node == 0; });
+    words.rebuild_free();
+    removed_ids.clear();
+    free_nodes = h.free_nodes;
+    free_topk = h.free_topk;
+
+    variant = h.variant;
+    layout = h.layout;
+    root = h.root;
+    global_counter = h.global_counter;
+    topk_k = h.topk_k;
+    topk_max_depth = h.topk_max_depth;
+    size = h.size;
+    propagation_steps = h.propagation_steps;
+    if (variant != RECENT) lazy_recent = false;
+    if (jump_len) enable_jump_table(jump_len);
 }
 
 /**
@@ -149,23 +1498,22 @@ void Trie::print_trie() const {
  * @param node Nodo actual en la recursión.
  * @param prefix Prefijo acumulado (no usado para la salida actual, pero útil si se extiende).
  */
-void Trie::print_trie_helper(TrieNode* node, string prefix) const {
-    if (!node) return;
+void Trie::print_trie_helper(uint32_t idx, string prefix) const {
+    if (!idx) return;
+    const TrieNode* node = &nodes[idx];
 
     if (node->is_terminal) {
-        cout << "Palabra: " << *(node->str)
+        cout << "Palabra: " << words.get(node->word)
                 << " | priority: " << node->priority
                 << " | best_terminal: "
-                << (node->best_terminal ? *(node->best_terminal->str) : "NULL")
+                << (node->best_terminal ? string(words.get(nodes[node->best_terminal].word)) : "NULL")
                 << "\n";
     }
 
-    for (int i = 0; i < 27; ++i) {
-        if (node->next[i]) {
-            char c = (i < 26) ? ('a' + i) : '$';
-            print_trie_helper(node->next[i], prefix + c);
-        }
-    }
+    children.for_each(node->children, [&](uint8_t i, uint32_t child) {
+        char c = (i < 26) ? ('a' + i) : '$';
+        print_trie_helper(child, prefix + c);
+    });
 }
 
 /**
@@ -176,3 +1524,11 @@ int Trie::get_size() const {
     return size;
 }
 
+/**
+ * @brief Devuelve la memoria ocupada por el Trie (nodos, hijos y palabras).
+ * @return Cantidad de bytes reservados.
+ */
+size_t Trie::memory_bytes() const {
+    return nodes.bytes() + children.bytes() + words.bytes();
+}
+
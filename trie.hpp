@@ -16,58 +16,128 @@
 #include <string>
 #include <cstdint>
 #include <iostream>
+#include <string_view>
+#include <vector>
+#include "pool.hpp"
+#include "children.hpp"
+#include "epoch.hpp"
+#include "prefix_index.hpp"
+#include "priority_policy.hpp"
+#include "successors.hpp"
 
 using namespace std;
 
 /**
  * @brief Nodo del Trie.
  *
- * Contiene punterros a hijos (`next`), puntero al padre, y campos usados
- * para indicar terminalidad y gestionar prioridades para el autocompletado.
+ * Los nodos viven en un `Pool` del Trie y se enlazan con índices de 32 bits
+ * (0 = nulo) en vez de punteros, lo que reduce el tamaño del nodo y mantiene
+ * los nodos en memoria contigua. Los hijos se guardan aparte en un bloque
+ * adaptativo (ver `ChildStore`).
  */
 struct TrieNode {
-    TrieNode* parent;                    /**< Puntero al padre */
-    array<TrieNode*,27> next;            /**< Punteros a hijos (a-z + extras) */
+    uint32_t parent;                     /**< Índice del padre */
+    uint32_t best_terminal;              /**< Índice del mejor terminal en el subárbol */
+    uint32_t word;                       /**< Id de la palabra en nodos terminales (0 si no hay) */
+    uint32_t priority;                   /**< Prioridad del nodo (para autocompletar) */
+    uint32_t best_priority;              /**< Prioridad del `best_terminal` */
+    uint32_t topk;                       /**< Lista top-k del nodo (0 si no tiene) */
+    ChildRef children;                   /**< Bloque de hijos (a-z + extras) */
     bool is_terminal;                    /**< True si el nodo marca el fin de una palabra */
-    string* str;                         /**< Almacena la palabra completa en nodos terminales */
-    uint64_t priority;                   /**< Prioridad del nodo (para autocompletar) */
-    TrieNode* best_terminal;             /**< Mejor terminal en el subárbol */
-    uint64_t best_priority;              /**< Prioridad del `best_terminal` */
-    
+    uint8_t spare[7];                    /**< Relleno explícito, siempre 0 (los snapshots copian el nodo tal cual) */
+
     /**
-     * @brief Constructor por defecto inicializa campos y arreglos.
+     * @brief Constructor por defecto inicializa los campos.
      */
     TrieNode();
+};
 
-    /**
-     * @brief Devuelve la cadena almacenada si es nodo terminal.
-     * @return Cadena almacenada o cadena vacía si no existe.
-     */
-    string get_str() const { return (str ? *str : ""); }
+/**
+ * @brief Candidato de una lista top-k: terminal y su prioridad al momento.
+ */
+struct TopKEntry {
+    uint32_t node;       /**< Índice del terminal (0 = entrada vacía) */
+    uint32_t priority;   /**< Prioridad del terminal */
 };
 
 /**
  * @brief Estructura Trie para autocompletado.
  *
- * Soporta dos variantes de priorización: FREQUENCY (conteo de usos) y RECENT
- * (prioriza por uso reciente). Proporciona las operaciones básicas necesarias
+ * Soporta tres variantes de priorización: FREQUENCY (conteo de usos), RECENT
+ * (prioriza por uso reciente) y DECAYED (conteo con decaimiento exponencial). Proporciona las operaciones básicas necesarias
  * para insertar palabras, navegar por prefijos y obtener sugerencias.
+ *
+ * Con `set_concurrent(true)` admite un hilo escritor (`insert`,
+ * `update_priority`, `remove`, `set_priority`) y varios lectores simultáneos que usan `descend`,
+ * `autocomplete`, `is_terminal` y `get_word` dentro de un `EpochGuard`. Esas
+ * operaciones no toman locks ni reintentan. El resto (top-k,
+ * `CompletionIterator`, construcción masiva) sigue siendo de un solo hilo.
  */
 class Trie {
     public:
     /**
      * @brief Construye un Trie vacío.
-     * @param variant_mode Variante de autocompletado: 0 = FREQUENCY, 1 = RECENT
+     * @param variant_mode Variante de autocompletado: 0 = FREQUENCY, 1 = RECENT, 2 = DECAYED
+     * @param layout_mode Layout de hijos: 0 = FIXED_LAYOUT, 1 = ADAPTIVE_LAYOUT
      */
-    Trie(int variant_mode);
+    Trie(int variant_mode, int layout_mode = ADAPTIVE_LAYOUT);
+
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
     
-    int variant; /**< Variante activa del autocompletado (FREQUENCY/RECENT) */
+    int variant; /**< Variante activa del autocompletado (FREQUENCY/RECENT/DECAYED) */
+
+    int layout;  /**< Layout de los hijos (FIXED_LAYOUT/ADAPTIVE_LAYOUT) */
     
     /**
      * @brief Inserta la palabra `w` en el Trie.
-     * @param w Palabra a insertar (por referencia constante).
+     * @param w Palabra a insertar.
+     * @return Nodo terminal de la palabra.
+     */
+    TrieNode* insert(string_view w);
+
+    /**
+     * @brief Carga un conjunto de palabras de una vez.
+     *
+     * Pensado para listas ordenadas (como words.txt): cada palabra reutiliza
+     * el camino común con la anterior en vez de bajar desde la raíz, y los
+     * nodos quedan en el pool en preorden. Al final calcula `best_terminal` y
+     * `best_priority` de todo el Trie en una sola pasada de abajo hacia arriba.
+     * Con entradas desordenadas el resultado es el mismo, sólo más lento.
+     *
+     * @param palabras Palabras a insertar.
+     * @param prioridades Prioridad inicial de cada palabra (vacío = todas en 0).
+     */
+    void build_sorted(const vector<string_view>& palabras, const vector<uint32_t>& prioridades = {});
+
+    /**
+     * @brief Igual que `build_sorted`, pero construye en paralelo.
+     *
+     * Las palabras se reparten por sus dos primeros caracteres entre `hilos`
+     * Tries independientes (cada uno con sus propios pools), que se
+     * construyen en paralelo y luego se copian bajo la raíz de este Trie.
+     * Sólo aplica sobre un Trie vacío; si no, o con un solo hilo, usa
+     * `build_sorted`. En empates de prioridad el terminal sugerido puede
+     * diferir del que elige `build_sorted`.
+     *
+     * @param palabras Palabras a insertar.
+     * @param prioridades Prioridad inicial de cada palabra (vacío = todas en 0).
+     * @param hilos Cantidad de hilos (0 = los que tenga la máquina).
      */
-    void insert(const string& w);
+    void build_parallel(const vector<string_view>& palabras, const vector<uint32_t>& prioridades = {},
+                        unsigned hilos = 0);
+
+    /**
+     * @brief Reordena los nodos y sus bloques de hijos para mejorar la localidad.
+     *
+     * Los nodos quedan en preorden visitando primero al hijo más caliente
+     * (el de mayor prioridad en su subárbol), de modo que el camino hacia las
+     * sugerencias más usadas ocupa memoria contigua. Se reescriben los enlaces
+     * a hijos, padres, mejores terminales, palabras y listas top-k, y se
+     * descartan los bloques libres. Invalida todo `TrieNode*` anterior; no
+     * debe haber lectores concurrentes mientras corre.
+     */
+    void compact();
 
     /**
      * @brief Desciende desde `v` por el carácter `c`.
@@ -84,23 +154,279 @@ class Trie {
      */
     TrieNode* autocomplete(TrieNode* v);
 
+    /**
+     * @brief Busca muchos prefijos a la vez intercalando sus descensos.
+     *
+     * Equivale a descender cada prefijo desde la raíz y pedir su
+     * `autocomplete`, pero mantiene `grupo` búsquedas en vuelo (AMAC): cada
+     * una pide a la caché el próximo nodo o bloque de hijos que necesita y
+     * cede el turno a la siguiente, de modo que las esperas a memoria de
+     * búsquedas independientes se solapan en vez de sumarse.
+     *
+     * @param prefijos Prefijos a buscar.
+     * @param nodos Salida: nodo de cada prefijo (`nullptr` si no existe).
+     * @param mejores Salida: mejor sugerencia de cada prefijo (o `nullptr`).
+     * @param grupo Búsquedas en vuelo (1 = una tras otra).
+     */
+    void lookup_batch(const vector<string_view>& prefijos, vector<TrieNode*>& nodos,
+                      vector<TrieNode*>& mejores, unsigned grupo = 16);
+
+    /**
+     * @brief Nodo del prefijo `p`, saltando los primeros niveles con la
+     * tabla de prefijos si está activa.
+     * @param p Prefijo a buscar.
+     * @return Nodo del prefijo o `nullptr` si no existe.
+     */
+    TrieNode* find_prefix(string_view p);
+
+    /**
+     * @brief Activa la tabla de prefijos cortos y la construye.
+     *
+     * Guarda el nodo de cada prefijo de largo 1..`largo` que exista (8 bytes
+     * por entrada, con ocupación entre 1/4 y 1/2). `insert` la mantiene al
+     * crear nodos. No admite lectores concurrentes: crecer la tabla mueve sus
+     * celdas. `largo = 0` la desactiva.
+     *
+     * @param largo Largo máximo de los prefijos (hasta `PrefixIndex::MAX_LEN`).
+     */
+    void enable_jump_table(uint32_t largo);
+
+    /**
+     * @brief Bytes ocupados por la tabla de prefijos.
+     */
+    size_t jump_bytes() const { return jumps.bytes(); }
+
+    /**
+     * @brief Activa las listas top-k por nodo y las reconstruye.
+     *
+     * Cada nodo con profundidad <= `max_depth` guarda, desde que algún
+     * terminal de su subárbol tiene prioridad, los `k` mejores terminales de
+     * su subárbol (8 bytes por entrada). `k = 0` desactiva las listas.
+     *
+     * @param k Capacidad de cada lista.
+     * @param max_depth Profundidad máxima de los nodos con lista.
+     */
+    void enable_topk(uint32_t k, uint32_t max_depth = UINT32_MAX);
+
+    /**
+     * @brief Obtiene las `k` mejores sugerencias en el subárbol de `v`.
+     *
+     * Usa la lista top-k del nodo si existe y alcanza; si no, recorre el
+     * subárbol con `autocomplete_topk_scan`.
+     *
+     * @param v Nodo desde el cual se consulta.
+     * @param k Cantidad de sugerencias.
+     * @return Terminales ordenados por prioridad descendente.
+     */
+    vector<TrieNode*> autocomplete_topk(TrieNode* v, uint32_t k);
+
+    /**
+     * @brief Calcula las `k` mejores sugerencias recorriendo todo el subárbol.
+     * @param v Nodo desde el cual se consulta.
+     * @param k Cantidad de sugerencias.
+     * @return Terminales ordenados por prioridad descendente.
+     */
+    vector<TrieNode*> autocomplete_topk_scan(TrieNode* v, uint32_t k);
+
+    /**
+     * @brief Sugerencias tolerantes a errores de tipeo.
+     *
+     * Devuelve las `k` palabras de mayor prioridad que tienen algún prefijo
+     * (la palabra completa incluida) a distancia de Levenshtein <= `max_edits`
+     * de `prefijo`. Recorre el Trie en orden de cota (`max(priority,
+     * best_priority)`) llevando una fila de la DP de edición por nodo: poda
+     * las ramas cuya fila ya supera `max_edits` y termina apenas las `k`
+     * mejores están decididas, sin visitar ramas cuya cota no les gana. De un
+     * solo hilo, como `CompletionIterator`.
+     *
+     * @param prefijo Prefijo escrito (posiblemente con errores).
+     * @param max_edits Cantidad máxima de ediciones (inserción, borrado o cambio).
+     * @param k Cantidad de sugerencias.
+     * @return Terminales ordenados por prioridad descendente.
+     */
+    vector<TrieNode*> fuzzy_autocomplete(string_view prefijo, uint32_t max_edits, uint32_t k);
+
+    /**
+     * @brief Bytes ocupados por las listas top-k.
+     */
+    size_t topk_bytes() const { return topk_lists.bytes(); }
+
+    /**
+     * @brief Activa las tablas de sucesores (predicción de la palabra
+     * siguiente) y borra las que hubiera.
+     *
+     * Cada palabra observada como anterior recibe un bloque de `capacidad`
+     * sucesores (8 bytes por entrada, ver `SuccessorTable`). `capacidad = 0`
+     * las desactiva.
+     *
+     * @param capacidad Sucesores guardados por palabra.
+     */
+    void enable_successors(uint32_t capacidad);
+
+    /**
+     * @brief Registra que la palabra de `siguiente` se usó después de la de `anterior`.
+     * @param anterior Terminal de la palabra anterior.
+     * @param siguiente Terminal de la palabra siguiente.
+     */
+    void observe_successor(const TrieNode* anterior, const TrieNode* siguiente);
+
+    /**
+     * @brief Predice las palabras que siguen a la de `anterior`.
+     *
+     * Lee el bloque de sucesores de la palabra: O(capacidad), sin recorrer
+     * el Trie. Omite los sucesores que ya no son terminales (borrados).
+     *
+     * @param anterior Terminal de la palabra anterior.
+     * @param k Cantidad de predicciones.
+     * @return Terminales en orden de conteo descendente.
+     */
+    vector<TrieNode*> predict_next(const TrieNode* anterior, uint32_t k = 1);
+
+    /**
+     * @brief Tablas de sucesores (capacidad, bloques y memoria).
+     */
+    const SuccessorTable& successor_table() const { return successors; }
+
     /**
      * @brief Actualiza la prioridad del nodo terminal `v` y propaga cambios.
      * @param v Nodo terminal cuya prioridad se actualiza.
      */
     void update_priority(TrieNode* v);
 
+    /**
+     * @brief Igual que `update_priority(TrieNode*)` con la política fijada en
+     * compilación, sin consultar `variant` (debe coincidir con ella).
+     * @tparam Policy `FrequencyPolicy`, `RecentPolicy`, ...
+     * @param v Nodo terminal cuya prioridad se actualiza.
+     */
+    template <class Policy>
+    void update_priority(TrieNode* v) {
+        if (!v || !v->is_terminal) return;  // seguridad
+        v->priority = Policy::bump(v->priority, global_counter);
+        if (lazy_recent) propagate_lazy(v);
+        else propagate(v);
+        if (Policy::needs_rescale(global_counter)) rescale();
+    }
+
+    /**
+     * @brief Activa el mantenimiento perezoso de los mejores terminales (sólo RECENT).
+     *
+     * En RECENT cada uso es el nuevo máximo global, así que la propagación
+     * normal reescribe `best_priority` en todos los ancestros. En modo
+     * perezoso `best_priority` pasa a ser una cota inferior: la prioridad
+     * exacta del mejor terminal se lee del propio terminal al consultarla.
+     * Un uso sólo escribe los ancestros cuya sugerencia cambia, y si la raíz
+     * ya sugiere la palabra no escribe nada.
+     *
+     * @param on true para activarlo.
+     */
+    void set_lazy_recent(bool on);
+
+    /**
+     * @brief Borra la palabra `w`.
+     *
+     * Los ancestros que la sugerían se reparan mirando sólo a sus hijos (ver
+     * `repair_best`). Los nodos que quedan sin hijos ni palabra se liberan,
+     * junto con su bloque de hijos y el id de la palabra, y `insert` los
+     * reutiliza: con altas y bajas repetidas la memoria no crece. Invalida
+     * los `TrieNode*` a nodos liberados (por ejemplo, los de un `TrieCursor`).
+     * En modo concurrente la palabra deja de ser terminal pero no se libera
+     * nada, porque un lector podría estar leyendo esos nodos.
+     *
+     * @param w Palabra a borrar.
+     * @return True si la palabra estaba en el Trie.
+     */
+    bool remove(string_view w);
+
+    /**
+     * @brief Fija la prioridad de la palabra `w`, que puede subir o bajar.
+     *
+     * Funciona con cualquier variante y también en modo RECENT perezoso. En
+     * RECENT el contador global queda por encima de la prioridad fijada.
+     *
+     * @param w Palabra.
+     * @param prioridad Prioridad nueva (0 = no se sugiere).
+     * @return True si la palabra estaba en el Trie.
+     */
+    bool set_priority(string_view w, uint32_t prioridad);
+
+    /**
+     * @brief Multiplica todas las prioridades por `factor` (envejecimiento).
+     *
+     * Recalcula los mejores terminales en una pasada y, si están activas, las
+     * listas top-k. Las prioridades que llegan a 0 dejan de sugerirse.
+     *
+     * @param factor Factor en [0, 1].
+     */
+    void decay(double factor);
+
+    /**
+     * @brief Indica si `v` corresponde a una palabra completa.
+     * @param v Nodo a consultar.
+     */
+    bool is_terminal(const TrieNode* v) const {
+        return v && __atomic_load_n(&v->is_terminal, __ATOMIC_ACQUIRE);
+    }
+
     /**
      * @brief Devuelve la raíz del Trie.
      * @return Puntero a la raíz.
      */
-    TrieNode* get_root() const { return root; }
+    TrieNode* get_root() { return &nodes[root]; }
+
+    /**
+     * @brief Devuelve la palabra almacenada en un nodo terminal.
+     * @param v Nodo a consultar.
+     * @return Palabra o cadena vacía si `v` no es terminal.
+     */
+    string get_str(const TrieNode* v) const { return string(get_word(v)); }
 
     /**
-     * @brief Establece la raíz (uso interno/experimental).
-     * @param r Nuevo nodo raíz.
+     * @brief Igual que `get_str` pero sin copiar la palabra.
+     * @param v Nodo a consultar.
+     * @return Vista a la palabra (válida mientras exista el Trie).
      */
-    void set_root(TrieNode* r) { root = r; }
+    string_view get_word(const TrieNode* v) const {
+        uint32_t id = v ? __atomic_load_n(&v->word, __ATOMIC_ACQUIRE) : 0;
+        return id ? words.get(id) : string_view();
+    }
+
+    /**
+     * @brief Guarda el Trie completo (nodos, hijos, palabras, prioridades y
+     * listas top-k) en un snapshot binario.
+     *
+     * Lanza `runtime_error` si no se puede escribir el archivo.
+     *
+     * @param ruta Ruta del archivo.
+     */
+    void save(const string& ruta) const;
+
+    /**
+     * @brief Reemplaza el contenido del Trie por el de un snapshot.
+     *
+     * La variante y el layout pasan a ser los del snapshot. Lanza
+     * `runtime_error` si el archivo no existe, está truncado, es de otra
+     * versión o no coincide su checksum; en ese caso el Trie no cambia.
+     *
+     * @param ruta Ruta del archivo.
+     */
+    void load(const string& ruta);
+
+    /**
+     * @brief Activa el modo de un escritor y muchos lectores.
+     *
+     * Desde aquí los bloques de hijos se copian al escribir y los viejos se
+     * reutilizan sólo cuando ningún lector registrado en `get_epochs()` puede
+     * estar leyéndolos. Debe llamarse sin lectores activos.
+     *
+     * @param on true para activar, false para volver al modo normal.
+     */
+    void set_concurrent(bool on) { children.set_concurrent(on ? &epochs : nullptr); }
+
+    /**
+     * @brief Épocas donde se registran los hilos lectores (ver `EpochReader`).
+     */
+    EpochManager& get_epochs() { return epochs; }
 
     /**
      * @brief Imprime el Trie en salida estándar (uso de depuración).
@@ -112,14 +438,198 @@ class Trie {
      * @return Número de nodos.
      */
     int get_size() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por nodos, hijos y palabras.
+     * @return Cantidad de bytes.
+     */
+    size_t memory_bytes() const;
+
+    /**
+     * @brief Cantidad total de ancestros visitados por `update_priority`.
+     */
+    uint64_t get_propagation_steps() const { return propagation_steps; }
+
+    /**
+     * @brief Contador de RECENT y DECAYED: el tiempo que recibe el próximo uso.
+     */
+    uint32_t get_counter() const { return global_counter; }
+
+    /**
+     * @brief Adelanta el contador hasta `contador` si está más atrás, para que
+     * los usos siguientes cuenten como posteriores a los de otro Trie.
+     * @param contador Contador mínimo.
+     */
+    void advance_counter(uint32_t contador) { global_counter = max(global_counter, contador); }
 private:
-    TrieNode* root;                    /**< Raíz del Trie */
+    Pool<TrieNode> nodes;      /**< Arena de nodos (índice 0 reservado) */
+    ChildStore children;       /**< Bloques de hijos de los nodos */
+    WordTable words;           /**< Palabras de los nodos terminales */
+
+    uint32_t root;             /**< Índice de la raíz del Trie */
 
-    uint64_t global_counter;   /**< Contador usado por la variante RECENT */
+    uint32_t global_counter;   /**< Contador usado por RECENT y DECAYED */
 
     uint64_t size; // tamaño
 
-    void print_trie_helper(TrieNode* node, std::string prefix) const;
+    uint64_t propagation_steps; /**< Pasos de propagación acumulados */
+
+    uint32_t topk_k;           /**< Capacidad de las listas top-k (0 = desactivadas) */
+    uint32_t topk_max_depth;   /**< Profundidad máxima con lista top-k */
+    Pool<TopKEntry, 10> topk_lists; /**< Listas top-k contiguas de `topk_k` entradas */
+
+    EpochManager epochs;       /**< Lectores concurrentes (modo `set_concurrent`) */
+
+    SuccessorTable successors; /**< Sucesores de cada palabra (ver `enable_successors`) */
+    vector<uint32_t> removed_ids; /**< Ids borrados que las tablas de sucesores aún pueden nombrar */
+
+    void release_removed_ids();
+
+    uint32_t jump_len;         /**< Largo máximo de la tabla de prefijos (0 = desactivada) */
+    PrefixIndex jumps;         /**< Nodos de los prefijos de largo 1..`jump_len` */
+
+    void update_topk(uint32_t self);
+
+    void propagate(TrieNode* v);
+
+    bool lazy_recent;          /**< Modo RECENT perezoso (ver `set_lazy_recent`) */
+
+    void propagate_lazy(TrieNode* v);
+
+    void rescale();
+
+    uint32_t free_nodes;       /**< Lista de nodos liberados (enlazada por `word`) */
+    uint32_t free_topk;        /**< Listas top-k de nodos liberados (enlazadas por la primera entrada) */
+
+    void repair_best(uint32_t node, uint32_t self);
+
+    void refresh_topk(uint32_t self);
+
+    void free_node(uint32_t idx);
+
+    friend class CompletionIterator;
+    friend class LoudsTrie;
+    friend class Dawg;
+
+    uint32_t new_node(uint32_t parent);
+
+    void rebuild_best();
+
+    void offer_best(TrieNode& n, uint32_t candidate, uint32_t prio) const;
+
+    void print_trie_helper(uint32_t node, std::string prefix) const;
+};
+
+/**
+ * @brief Iterador perezoso sobre las completaciones de un prefijo.
+ *
+ * Entrega los terminales del subárbol de un nodo en orden de prioridad
+ * descendente, expandiendo el Trie de mejor a peor (best-first) con un heap.
+ * La cota de cada subárbol es `max(priority, best_priority)` de su raíz, que
+ * es exacta, así que con `limit` resultados pendientes basta conservar las
+ * `limit` mejores entradas del heap. Cada `next` cuesta O(log heap) por nodo
+ * expandido, sin recorrer el subárbol completo.
+ *
+ * El iterador guarda índices de nodo: puede seguir usándose después de
+ * insertar palabras, pero el orden sólo es exacto respecto a las prioridades
+ * vigentes al momento de expandir cada nodo.
+ */
+class CompletionIterator {
+    public:
+    /**
+     * @brief Crea un iterador sobre las completaciones bajo `v` (sin incluir `v`).
+     * @param trie Trie a recorrer.
+     * @param v Nodo del prefijo.
+     * @param limit Cantidad máxima de resultados a entregar.
+     * @param min_priority Prioridad mínima de los resultados (0 = todos).
+     */
+    CompletionIterator(Trie& trie, TrieNode* v, uint32_t limit = UINT32_MAX, uint32_t min_priority = 1);
+
+    /**
+     * @brief Devuelve la siguiente completación.
+     * @return Nodo terminal o `nullptr` si no quedan más.
+     */
+    TrieNode* next();
+
+    /**
+     * @brief Cantidad de entradas actualmente en el heap.
+     */
+    size_t heap_size() const { return heap.size(); }
+private:
+    /** @brief Entrada del heap: un terminal a entregar o un subárbol a expandir. */
+    struct Entry {
+        uint32_t bound;     /**< Prioridad (terminal) o cota (subárbol) */
+        uint32_t node;      /**< Índice del nodo */
+        bool terminal;      /**< True si se entrega `node`, false si se expande */
+    };
+
+    Trie& trie;
+    vector<Entry> heap;        /**< Heap de máximo por `bound` */
+    uint32_t remaining;        /**< Resultados que aún se pueden entregar */
+    uint32_t min_priority;     /**< Cota mínima para entrar al heap */
+
+    static bool menor_cota(const Entry& a, const Entry& b);
+    void push(const Entry& e);
+    void push_subtree(uint32_t node);
+};
+
+/**
+ * @brief Sesión de escritura sobre un Trie: el prefijo se arma carácter a
+ * carácter en vez de descender desde la raíz en cada tecla.
+ *
+ * Guarda la pila de nodos visitados, de modo que `push` (un `descend`),
+ * `pop` (retroceso) y `best` (un `autocomplete`) cuestan O(1). Si el prefijo
+ * deja de existir se siguen contando los caracteres sobrantes, para que al
+ * borrarlos se vuelva exactamente al último nodo válido.
+ *
+ * Los nodos no se mueven al insertar, así que el cursor sigue siendo válido
+ * mientras el Trie crece.
+ */
+class TrieCursor {
+    public:
+    /**
+     * @brief Crea un cursor en la raíz (prefijo vacío).
+     * @param trie Trie a recorrer.
+     */
+    explicit TrieCursor(Trie& trie);
+
+    /**
+     * @brief Agrega un carácter al prefijo.
+     * @param c Carácter escrito.
+     * @return True si el nuevo prefijo existe en el Trie.
+     */
+    bool push(char c);
+
+    /**
+     * @brief Quita el último carácter del prefijo (sin efecto si está vacío).
+     */
+    void pop();
+
+    /**
+     * @brief Vuelve al prefijo vacío.
+     */
+    void reset();
+
+    /**
+     * @brief Mejor sugerencia para el prefijo actual.
+     * @return Nodo terminal o `nullptr` si no hay (o el prefijo no existe).
+     */
+    TrieNode* best() const { return trie.autocomplete(node()); }
+
+    /**
+     * @brief Nodo del prefijo actual (`nullptr` si no existe).
+     */
+    TrieNode* node() const { return missing ? nullptr : path.back(); }
+
+    /**
+     * @brief Cantidad de caracteres del prefijo actual.
+     */
+    size_t depth() const { return path.size() - 1 + missing; }
+
+private:
+    Trie& trie;
+    vector<TrieNode*> path;   /**< Nodos visitados; `path[0]` es la raíz */
+    size_t missing;           /**< Caracteres escritos después del último nodo existente */
 };
 
-#endif
\ No newline at end of file
+#endif
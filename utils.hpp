@@ -10,7 +10,10 @@
 #include <string>
 #include <iostream>
 #include "trie.hpp"
+#include "priority_policy.hpp"
+#include "tokenizer.hpp"
 #include <chrono>
+#include <type_traits>
 
 #include <stdexcept>
 
@@ -25,14 +28,6 @@ using namespace std;
  * de autocompletado. Está pensado como apoyo a la interfaz gráfica y pruebas.
  */
 
-/**
- * @brief Variante de priorización para autocompletado.
- *
- * - `FREQUENCY` (0): incrementa contador por cada uso de la palabra.
- * - `RECENT` (1): asigna prioridades según un contador global para priorizar lo más reciente.
- */
-enum Variant { FREQUENCY = 0, RECENT = 1 };
-
 // Forward declaration de Trie para evitar dependencia circular
 class Trie;
 struct TrieNode;
@@ -55,21 +50,19 @@ inline int charToIndex(char c) {
 /**
  * @brief Cargar un archivo de palabras en el `Trie` (modo no-verbose).
  *
- * Lee el archivo `rutaArchivo`, inserta cada palabra leída en `trie` y muestra
- * información periódica sobre el progreso y tiempos. Lanza excepción si no
- * puede abrir el archivo.
+ * Lee el archivo `rutaArchivo` con `Tokenizer` (mapeado en memoria, sin
+ * copiar las palabras), inserta cada palabra leída en `trie` y muestra
+ * información periódica sobre el progreso, tiempos y el throughput final.
+ * Lanza excepción si no puede abrir el archivo.
  *
  * @param trie Trie donde se insertan las palabras.
  * @param rutaArchivo Ruta al archivo de palabras.
+ * @param normalizar true para pasar a minúsculas y separar por puntuación.
  */
-inline void cargarArchivoPalabras(Trie& trie, const std::string& rutaArchivo) {
-    std::ifstream archivo(rutaArchivo);
-    
-    if (!archivo.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
-    }
-    
-    std::string palabra;
+inline void cargarArchivoPalabras(Trie& trie, const std::string& rutaArchivo, bool normalizar = false) {
+    Tokenizer tokens(rutaArchivo, normalizar);
+    std::string_view palabra;
+    auto inicio = std::chrono::high_resolution_clock::now();
 
 
     int i = 0;
@@ -77,7 +70,7 @@ inline void cargarArchivoPalabras(Trie& trie, const std::string& rutaArchivo) {
     int group_counter = 0;
     int word_mark = 16384;
 
-    while (archivo >> palabra) {
+    while (tokens.next(palabra)) {
         auto start = std::chrono::high_resolution_clock::now();
         trie.insert(palabra);
         i++;
@@ -95,11 +88,13 @@ inline void cargarArchivoPalabras(Trie& trie, const std::string& rutaArchivo) {
         if ( i == marca) {
             cout << "Insercion numero: " << i << "\n";
             cout << "Cantidad de nodos del trie: " << trie.get_size() << "\n";
+            cout << "Memoria ocupada por el trie (bytes): " << trie.memory_bytes() << "\n";
             e++;
         }
     }
     
-    archivo.close();
+    std::chrono::duration<double> total = std::chrono::high_resolution_clock::now() - inicio;
+    cout << "Throughput de carga: " << tokens.size() / 1e6 / total.count() << " MB/s\n";
     cout << " === === \n";
 
 }
@@ -111,30 +106,50 @@ inline void cargarArchivoPalabras(Trie& trie, const std::string& rutaArchivo) {
  * funciona con la política actual del `Trie`. Actualiza prioridades a medida
  * que encuentra palabras (simula que el usuario las acepta/usa).
  *
+ * Es genérica sobre la estructura: sirve para `Trie` y para `RadixTrie`, que
+ * comparten `descend`, `autocomplete`, `is_terminal` y `update_priority`.
+ * Si el `Trie` tiene tablas de sucesores activas (`enable_successors`),
+ * además predice cada palabra a partir de la anterior antes de verla, cuenta
+ * los aciertos y aprende el bigrama.
+ *
+ * @tparam Policy Política de prioridad (debe coincidir con `trie.variant`).
  * @param trie Trie a utilizar.
  * @param rutaArchivo Ruta del archivo de palabras.
+ * @param normalizar true para pasar a minúsculas y separar por puntuación
+ *        (ver `Tokenizer`); por defecto se usan las palabras tal cual.
  */
-inline void recorrer(Trie& trie, const std::string& rutaArchivo) {
-    std::ifstream archivo(rutaArchivo);
-    
-    if (!archivo.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
-    }
+template <class Policy, typename T>
+inline void recorrerCon(T& trie, const std::string& rutaArchivo, bool normalizar = false) {
+    Tokenizer tokens(rutaArchivo, normalizar);
+    auto inicio = std::chrono::high_resolution_clock::now();
     
     uint64_t total_char = 0;      // caracteres totales del texto
     uint64_t total_escrito = 0;   // caracteres que el usuario escribe
     int i = 0;
     int e = 0;
+    uint64_t predicciones = 0;    // palabras con una anterior a partir de la cual predecir
+    uint64_t aciertos = 0;        // la palabra siguiente predicha fue la correcta
     
-    std::string palabra;
+    std::string_view palabra;
+    decltype(trie.insert(palabra)) anterior = nullptr;  // terminal de la palabra anterior
     
-    while (archivo >> palabra) {
-        trie.insert(palabra);
+    while (tokens.next(palabra)) {
+        auto terminal = trie.insert(palabra);
         i++;
+
+        if constexpr (std::is_same<T, Trie>::value) {
+            if (anterior && trie.successor_table().capacity()) {
+                std::vector<TrieNode*> siguiente = trie.predict_next(anterior, 1);
+                predicciones++;
+                if (!siguiente.empty() && siguiente[0] == terminal) aciertos++;
+                trie.observe_successor(anterior, terminal);
+            }
+        }
+        anterior = terminal;
         
         total_char += palabra.length();  // siempre cuenta el largo total
         
-        TrieNode* node = trie.get_root();
+        auto node = trie.get_root();
         int chars_escritos_palabra = 0;  // contador para esta palabra específica
         bool autocompletado = false;
 
@@ -142,15 +157,15 @@ inline void recorrer(Trie& trie, const std::string& rutaArchivo) {
             node = trie.descend(node, c);
             chars_escritos_palabra++;
 
-            if (node == nullptr) {
+            if (!node) {
                 // no existe el prefijo → el usuario escribe todo
                 total_escrito += palabra.length();
                 autocompletado = false;
                 break;
             }
 
-            TrieNode* best = trie.autocomplete(node);
-            if (best != nullptr && best->get_str() == palabra) {
+            auto best = trie.autocomplete(node);
+            if (best && trie.get_word(best) == palabra) {
                 // se pudo autocompletar
                 total_escrito += chars_escritos_palabra;
                 autocompletado = true;
@@ -159,13 +174,13 @@ inline void recorrer(Trie& trie, const std::string& rutaArchivo) {
         }
 
         // si recorrió toda la palabra sin autocompletar ni fallar
-        if (!autocompletado && node != nullptr) {
+        if (!autocompletado && node) {
             total_escrito += palabra.length();
         }
 
         // actualiza prioridad si la palabra existe
-        if (node != nullptr && node->is_terminal) {
-            trie.update_priority(node);
+        if (node && trie.is_terminal(node)) {
+            trie.template update_priority<Policy>(node);
         }
 
         uint64_t marca = (1ULL << e);
@@ -181,12 +196,37 @@ inline void recorrer(Trie& trie, const std::string& rutaArchivo) {
         }
     }
 
-    archivo.close();
+    std::chrono::duration<double> total = std::chrono::high_resolution_clock::now() - inicio;
 
     cout << "\n=== RESULTADOS FINALES ===\n";
     cout << "Total de caracteres escritos: " << total_escrito << "\n";
     cout << "Total de caracteres: " << total_char << "\n";
-    cout << "Porcentaje final: " << (double)total_escrito / total_char * 100 << "%\n\n";
+    cout << "Porcentaje final: " << (double)total_escrito / total_char * 100 << "%\n";
+    if constexpr (std::is_same<T, Trie>::value) {
+        const SuccessorTable& sucesores = trie.successor_table();
+        if (predicciones) {
+            cout << "Prediccion de la siguiente palabra: " << (double)aciertos / predicciones * 100
+                 << "% de aciertos, " << (double)sucesores.bytes() / sucesores.tables()
+                 << " bytes por palabra con sucesores (" << sucesores.tables() << " palabras)\n";
+        }
+    }
+    cout << "Throughput: " << tokens.size() / 1e6 / total.count() << " MB/s\n\n";
+}
+
+/**
+ * @brief Recorre un archivo simulando escritura con autocompletado (ver
+ * `recorrerCon`).
+ *
+ * Elige la política de prioridad según `trie.variant` una sola vez, de modo
+ * que el ciclo por palabra se compila sin ramas por variante.
+ *
+ * @param trie Trie a utilizar.
+ * @param rutaArchivo Ruta del archivo de palabras.
+ * @param normalizar true para pasar a minúsculas y separar por puntuación.
+ */
+template <typename T>
+inline void recorrer(T& trie, const std::string& rutaArchivo, bool normalizar = false) {
+    withPolicy(trie.variant, [&](auto p) { recorrerCon<decltype(p)>(trie, rutaArchivo, normalizar); });
 }
 
 /**
@@ -199,20 +239,15 @@ inline void recorrer(Trie& trie, const std::string& rutaArchivo) {
  * @param rutaArchivo Ruta al archivo a leer.
  */
 inline void cargarArchivoPalabrasConDebug(Trie& trie, const std::string& rutaArchivo) {
-    std::ifstream archivo(rutaArchivo);
-    
-    if (!archivo.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
-    }
-    
-    std::string palabra;
+    Tokenizer tokens(rutaArchivo);
+    std::string_view palabra;
     int contador = 0;
     
     std::cout << "========================================\n";
     std::cout << "INICIANDO CARGA DE caracteres DESDE: " << rutaArchivo << "\n";
     std::cout << "========================================\n\n";
     
-    while (archivo >> palabra) {
+    while (tokens.next(palabra)) {
         contador++;
         std::cout << "--- Paso " << contador << " ---\n";
         std::cout << "Insertando palabra: \"" << palabra << "\"\n";
@@ -224,8 +259,6 @@ inline void cargarArchivoPalabrasConDebug(Trie& trie, const std::string& rutaArc
         std::cout << "\n";
     }
     
-    archivo.close();
-    
     std::cout << "========================================\n";
     std::cout << "CARGA COMPLETADA\n";
     std::cout << "Total de palabras procesadas: " << contador << "\n";
@@ -0,0 +1,272 @@
+/**
+ * @file wal.hpp
+ * @brief Registro de escritura adelantada (WAL) de inserciones y usos de palabras.
+ *
+ * Cada evento (`insert` o `update_priority`) se guarda como un registro con
+ * la palabra y su checksum. Los registros se acumulan en memoria y un hilo
+ * los escribe y hace `fsync` por grupos (group commit): un `fsync` cubre a
+ * todos los registros que llegaron mientras se escribía el anterior, así que
+ * el costo de durabilidad se reparte entre muchas actualizaciones.
+ *
+ * Al recuperar, los registros se aplican en orden sobre el Trie. Como las
+ * prioridades dependen sólo del orden de los eventos (conteos en FREQUENCY y
+ * el contador global en RECENT), repetirlos reconstruye exactamente el mismo
+ * estado. Un registro incompleto o con checksum inválido marca el final del
+ * log (una escritura cortada por una caída).
+ *
+ * Autor: Benjamín Quiroz Villanueva (RUT: 20.265.703-6)
+ */
+
+#ifndef WAL_HPP
+#define WAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "snapshot.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Tipo de evento registrado.
+ */
+enum LogEvent : uint8_t { LOG_INSERT = 1, LOG_USE = 2, LOG_NEXT = 3, LOG_SUCCESSORS = 4 };
+
+/**
+ * @brief Fuerza a disco el contenido de un archivo ya escrito y cerrado.
+ * @param ruta Ruta del archivo.
+ */
+inline void sincronizarArchivo(const string& ruta) {
+#ifdef _WIN32
+    HANDLE h = CreateFileA(ruta.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) throw runtime_error("No se pudo abrir el archivo: " + ruta);
+    FlushFileBuffers(h);
+    CloseHandle(h);
+#else
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("No se pudo abrir el archivo: " + ruta);
+    fsync(fd);
+    close(fd);
+#endif
+}
+
+/**
+ * @brief Reemplaza `destino` por `origen` de forma atómica (y durable en POSIX).
+ * @param origen Archivo temporal ya sincronizado.
+ * @param destino Nombre final.
+ */
+inline void reemplazarArchivo(const string& origen, const string& destino) {
+#ifdef _WIN32
+    if (!MoveFileExA(origen.c_str(), destino.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw runtime_error("No se pudo renombrar el archivo: " + origen);
+    }
+#else
+    if (rename(origen.c_str(), destino.c_str()) != 0) {
+        throw runtime_error("No se pudo renombrar el archivo: " + origen);
+    }
+    // el rename queda durable al sincronizar el directorio
+    size_t barra = destino.find_last_of('/');
+    string dir = (barra == string::npos) ? "." : destino.substr(0, barra + 1);
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+}
+
+/**
+ * @brief Log de eventos con escritura en segundo plano y fsync por grupos.
+ *
+ * Formato de cada registro: tipo (1 byte), largo de la palabra (4 bytes),
+ * la palabra y un checksum de 4 bytes sobre todo lo anterior.
+ */
+class PriorityLog {
+public:
+    /**
+     * @brief Abre (o crea) un segmento de log para agregar registros.
+     * @param ruta Ruta del segmento.
+     * @param grupo Bytes pendientes que disparan una escritura sin esperar.
+     * @param espera_ms Tiempo máximo que un registro espera su `fsync`.
+     */
+    PriorityLog(const string& ruta, size_t grupo = 64 << 10, unsigned espera_ms = 10)
+        : path(ruta), group_bytes(grupo), wait_ms(espera_ms) {
+        file = fopen(ruta.c_str(), "ab");
+        if (!file) throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        flusher = thread([this]() { run(); });
+    }
+
+    ~PriorityLog() {
+        {
+            lock_guard<mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        flusher.join();
+        fclose(file);
+    }
+
+    PriorityLog(const PriorityLog&) = delete;
+    PriorityLog& operator=(const PriorityLog&) = delete;
+
+    /**
+     * @brief Agrega un evento (no espera a que llegue a disco).
+     * @param tipo `LOG_INSERT`, `LOG_USE`, `LOG_NEXT` o `LOG_SUCCESSORS`.
+     * @param w Palabra (en `LOG_NEXT`, las dos palabras separadas por un
+     *        espacio; en `LOG_SUCCESSORS`, la capacidad en decimal).
+     * @return Número de secuencia del registro (ver `sync`).
+     */
+    uint64_t append(LogEvent tipo, string_view w) {
+        unsigned char cabecera[5];
+        uint32_t largo = (uint32_t)w.size();
+        cabecera[0] = tipo;
+        memcpy(cabecera + 1, &largo, 4);
+        Checksum sum;
+        sum.update(cabecera, 5);
+        sum.update(w.data(), w.size());
+        uint32_t check = (uint32_t)sum.digest();
+
+        lock_guard<mutex> lock(m);
+        pending.insert(pending.end(), cabecera, cabecera + 5);
+        pending.insert(pending.end(), w.begin(), w.end());
+        const char* c = reinterpret_cast<const char*>(&check);
+        pending.insert(pending.end(), c, c + 4);
+        appended++;
+        if (pending.size() >= group_bytes) cv.notify_all();
+        return appended;
+    }
+
+    /**
+     * @brief Espera a que todos los registros agregados hasta ahora estén en disco.
+     */
+    void sync() {
+        unique_lock<mutex> lock(m);
+        uint64_t objetivo = appended;
+        sync_requested = true;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return durable >= objetivo || failed; });
+        if (failed) throw runtime_error("No se pudo escribir el archivo: " + path);
+    }
+
+    /** @brief Registros agregados. */
+    uint64_t appended_records() {
+        lock_guard<mutex> lock(m);
+        return appended;
+    }
+
+    /** @brief Cantidad de `fsync` hechos (cada uno cubre un grupo). */
+    uint64_t fsyncs() {
+        lock_guard<mutex> lock(m);
+        return syncs;
+    }
+
+    /**
+     * @brief Aplica los registros de un segmento con `f(tipo, palabra)`.
+     *
+     * Se detiene en el primer registro incompleto o con checksum inválido.
+     *
+     * @param ruta Ruta del segmento.
+     * @param f Función llamada por cada registro válido.
+     * @return Cantidad de registros aplicados.
+     */
+    template <typename F>
+    static uint64_t replay(const string& ruta, F f) {
+        MappedFile archivo(ruta);
+        const char* p = archivo.size() ? archivo.map(0, archivo.size()) : nullptr;
+        uint64_t n = archivo.size(), pos = 0, registros = 0;
+
+        while (n - pos >= 9) {
+            uint8_t tipo = (uint8_t)p[pos];
+            uint32_t largo, check;
+            memcpy(&largo, p + pos + 1, 4);
+            if (largo > n - pos - 9) break;  // registro cortado
+
+            Checksum sum;
+            sum.update(p + pos, 5 + (size_t)largo);
+            memcpy(&check, p + pos + 5 + largo, 4);
+            if (check != (uint32_t)sum.digest() || tipo < LOG_INSERT || tipo > LOG_SUCCESSORS) break;
+
+            f((LogEvent)tipo, string_view(p + pos + 5, largo));
+            pos += 9 + (uint64_t)largo;
+            registros++;
+        }
+        return registros;
+    }
+
+private:
+    string path;
+    FILE* file;
+    size_t group_bytes;
+    unsigned wait_ms;
+
+    mutex m;
+    condition_variable cv;
+    vector<char> pending;          /**< Registros aún no escritos */
+    uint64_t appended = 0;         /**< Registros agregados */
+    uint64_t durable = 0;          /**< Registros ya sincronizados */
+    uint64_t syncs = 0;            /**< `fsync` realizados */
+    bool sync_requested = false;
+    bool stop = false;
+    bool failed = false;
+    thread flusher;
+
+    /**
+     * @brief Hilo de escritura: toma todo lo pendiente, lo escribe y hace un
+     * solo `fsync` para el grupo.
+     */
+    void run() {
+        vector<char> escribiendo;
+        unique_lock<mutex> lock(m);
+        while (true) {
+            cv.wait_for(lock, chrono::milliseconds(wait_ms), [&]() {
+                return stop || sync_requested || pending.size() >= group_bytes;
+            });
+            if (pending.empty()) {
+                sync_requested = false;
+                if (stop) return;
+                continue;
+            }
+
+            escribiendo.swap(pending);
+            uint64_t hasta = appended;
+            sync_requested = false;
+            lock.unlock();
+
+            bool ok = fwrite(escribiendo.data(), 1, escribiendo.size(), file) == escribiendo.size() &&
+                      fflush(file) == 0;
+#ifdef _WIN32
+            ok = ok && _commit(_fileno(file)) == 0;
+#else
+            ok = ok && fsync(fileno(file)) == 0;
+#endif
+            escribiendo.clear();
+
+            lock.lock();
+            if (ok) {
+                durable = hasta;
+                syncs++;
+            } else {
+                failed = true;
+            }
+            cv.notify_all();
+        }
+    }
+};
+
+#endif